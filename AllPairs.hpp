@@ -0,0 +1,224 @@
+#ifndef ALLPAIRS_HPP
+#define ALLPAIRS_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+#include "Graph.hpp"
+#include "ThreadPool.hpp"
+
+// all-pairs shortest paths of a dense graph: the lengths are copied into one
+// padded matrix and blocked Floyd-Warshall runs over square tiles, tiles of
+// the same phase are independent and split between threads
+// negative lengths are allowed, negative cycles are reported
+class AllPairs {
+public:
+	AllPairs() = default;
+	AllPairs(const AllPairs&) = default;
+	AllPairs(AllPairs&&) = default;
+	AllPairs& operator=(const AllPairs&) = default;
+	AllPairs& operator=(AllPairs&&) = default;
+	~AllPairs() = default;
+
+	// next hops are needed by path(), threads: 0 - one per hardware thread,
+	// they are started for the build only, queries are not parallel
+	template <typename V, typename E, typename F>
+	static AllPairs
+	build(const Graph<V, E>&, F, bool = false, std::size_t = 0);
+
+	std::size_t nrOfVertices() const;
+	// infinity if there is no path
+	double distance(std::size_t, std::size_t) const;
+	bool hasNextHops() const;
+	// same result as Graph::dijkstra
+	std::pair<double, std::vector<std::size_t>>
+	path(std::size_t, std::size_t) const;
+
+private:
+	// 64 x 64 doubles, three tiles of a kernel call stay in L2
+	static constexpr std::size_t TILE = 64;
+	static constexpr double INF = std::numeric_limits<double>::infinity();
+
+	// c[i][j] = min(c[i][j], a[i][k] + b[k][j]) for one tile, the tiles may
+	// be the same one, which gives plain Floyd-Warshall inside it
+	void relax(std::size_t, std::size_t, std::size_t);
+	void run(std::size_t);
+
+	std::size_t m_vertices{0};
+	// row length, a multiple of TILE
+	std::size_t m_stride{0};
+	std::vector<double> m_distance{};
+	// first vertex after the row vertex on a shortest path
+	std::vector<std::uint32_t> m_next{};
+	// only while building next hops, equal lengths are compared by number of
+	// edges, otherwise zero length cycles could make next hops loop
+	std::vector<std::uint32_t> m_hops{};
+};
+
+////////////////////////////////////////
+// AllPairs implementation
+////////////////////////////////////////
+
+template <typename V, typename E, typename F>
+AllPairs AllPairs::build(
+	const Graph<V, E>& graph,
+	F f,
+	bool next_hops,
+	std::size_t threads)
+{
+	AllPairs out{};
+	out.m_vertices = graph.nrOfVertices();
+	out.m_stride = (out.m_vertices + TILE - 1) / TILE * TILE;
+	out.m_distance.assign(out.m_stride * out.m_stride, INF);
+	if (next_hops) {
+		out.m_next.assign(
+			out.m_stride * out.m_stride,
+			std::numeric_limits<std::uint32_t>::max());
+		out.m_hops.assign(out.m_stride * out.m_stride, 0);
+	}
+	// padding keeps a zero diagonal too, so it never shortens anything
+	for (std::size_t i = 0; i < out.m_stride; ++i) {
+		out.m_distance[i * out.m_stride + i] = 0;
+		if (next_hops)
+			out.m_next[i * out.m_stride + i] = static_cast<std::uint32_t>(i);
+	}
+	for (auto it = graph.beginEdges(); it != graph.endEdges(); ++it) {
+		const auto index = it.v1id() * out.m_stride + it.v2id();
+		const auto length = static_cast<double>(f(*it));
+		if (length < out.m_distance[index]) {
+			out.m_distance[index] = length;
+			if (next_hops) {
+				out.m_next[index] = static_cast<std::uint32_t>(it.v2id());
+				out.m_hops[index] = it.v1id() != it.v2id();
+			}
+		}
+	}
+	out.run(threads);
+	out.m_hops = std::vector<std::uint32_t>{};
+	for (std::size_t i = 0; i < out.m_vertices; ++i)
+		if (out.m_distance[i * out.m_stride + i] < 0)
+			throw std::domain_error{"Graf zawiera ujemny cykl"};
+	return out;
+}
+
+inline std::size_t AllPairs::nrOfVertices() const
+{
+	return m_vertices;
+}
+
+inline double AllPairs::distance(std::size_t from, std::size_t to) const
+{
+	return m_distance[from * m_stride + to];
+}
+
+inline bool AllPairs::hasNextHops() const
+{
+	return !m_next.empty() || m_vertices == 0;
+}
+
+inline std::pair<double, std::vector<std::size_t>>
+AllPairs::path(std::size_t from, std::size_t to) const
+{
+	if (!hasNextHops())
+		throw std::logic_error{"Brak macierzy następników"};
+	const auto length = distance(from, to);
+	if (length == INF)
+		throw std::runtime_error{"No valid path"};
+	std::vector<std::size_t> out{from};
+	for (auto node = from; node != to; node = m_next[node * m_stride + to])
+		out.push_back(m_next[node * m_stride + to]);
+	return std::make_pair(length, out);
+}
+
+inline void AllPairs::relax(std::size_t c, std::size_t a, std::size_t b)
+{
+	// a tile is given by the index of its top left element
+	auto* distance = m_distance.data();
+	for (std::size_t k = 0; k < TILE; ++k) {
+		const auto* b_row = distance + b + k * m_stride;
+		for (std::size_t i = 0; i < TILE; ++i) {
+			const auto a_value = distance[a + i * m_stride + k];
+			if (a_value == INF)
+				continue;
+			auto* c_row = distance + c + i * m_stride;
+			if (!m_next.empty()) {
+				// scalar, the next hop follows the distance
+				const auto a_next = m_next[a + i * m_stride + k];
+				const auto a_hops = m_hops[a + i * m_stride + k];
+				const auto* b_hops = m_hops.data() + b + k * m_stride;
+				auto* next_row = m_next.data() + c + i * m_stride;
+				auto* hops_row = m_hops.data() + c + i * m_stride;
+				for (std::size_t j = 0; j < TILE; ++j) {
+					const auto sum = a_value + b_row[j];
+					const auto hops = a_hops + b_hops[j];
+					if (sum < c_row[j]
+						|| (sum == c_row[j] && hops < hops_row[j])) {
+						c_row[j] = sum;
+						next_row[j] = a_next;
+						hops_row[j] = hops;
+					}
+				}
+				continue;
+			}
+#ifdef __AVX2__
+			const auto broadcast = _mm256_set1_pd(a_value);
+			for (std::size_t j = 0; j < TILE; j += 4) {
+				const auto sum
+					= _mm256_add_pd(broadcast, _mm256_loadu_pd(b_row + j));
+				_mm256_storeu_pd(
+					c_row + j, _mm256_min_pd(_mm256_loadu_pd(c_row + j), sum));
+			}
+#else
+			for (std::size_t j = 0; j < TILE; ++j)
+				c_row[j] = std::min(c_row[j], a_value + b_row[j]);
+#endif
+		}
+	}
+}
+
+inline void AllPairs::run(std::size_t threads)
+{
+	const auto tiles = m_stride / TILE;
+	if (tiles == 0)
+		return;
+	ThreadPool pool{std::min(ThreadPool::threadCount(threads), tiles * tiles)};
+	const auto tile = [this](std::size_t row, std::size_t column) {
+		return row * TILE * m_stride + column * TILE;
+	};
+
+	for (std::size_t k = 0; k < tiles; ++k) {
+		const auto pivot = tile(k, k);
+		relax(pivot, pivot, pivot);
+		// the pivot row and column depend only on the pivot tile
+		pool.parallelFor(2 * tiles, [&](std::size_t, std::size_t index) {
+			const auto other = index / 2;
+			if (other == k)
+				return;
+			if (index % 2 == 0) {
+				const auto t = tile(k, other);
+				relax(t, pivot, t);
+			} else {
+				const auto t = tile(other, k);
+				relax(t, t, pivot);
+			}
+		});
+		// the rest only on the pivot row and column
+		pool.parallelFor(tiles * tiles, [&](std::size_t, std::size_t index) {
+			const auto row = index / tiles;
+			const auto column = index % tiles;
+			if (row == k || column == k)
+				return;
+			relax(tile(row, column), tile(row, k), tile(k, column));
+		});
+	}
+}
+
+#endif /* ALLPAIRS_HPP */
@@ -26,13 +26,18 @@ public:
 	const V& operator*() const;
 	V* operator->() const;
 
+	// number of edges from the start vertex
+	std::size_t depth() const;
+
 private:
 	BFSIterator(const Graph& graph, std::size_t node);
 	BFSIterator(const Graph& graph);
 
 	const Graph& m_graph;
 	std::size_t m_current{0};
-	std::queue<std::size_t> m_queue{};
+	std::size_t m_depth{0};
+	// (vertex, depth)
+	std::queue<std::pair<std::size_t, std::size_t>> m_queue{};
 	std::vector<bool> m_visited{};
 };
 
@@ -59,20 +64,22 @@ typename Graph<V, E>::BFSIterator& Graph<V, E>::BFSIterator::operator++()
 		return *this;
 
 	std::size_t tmp;
+	std::size_t depth;
 	do {
 		if (m_queue.empty()) {
 			m_current = m_graph.nrOfVertices();
 			return *this;
 		}
-		tmp = m_queue.front();
+		std::tie(tmp, depth) = m_queue.front();
 		m_queue.pop();
 	} while (m_visited[tmp]);
 	m_visited[tmp] = true;
 	for (std::size_t i = 0; i < m_graph.m_data[tmp].second.size(); ++i) {
 		if (m_graph.edgeExist(tmp, i))
-			m_queue.push(i);
+			m_queue.emplace(i, depth + 1);
 	}
 	m_current = tmp;
+	m_depth = depth;
 	return *this;
 }
 
@@ -96,12 +103,18 @@ V* Graph<V, E>::BFSIterator::operator->() const
 	return m_graph.m_data[m_current].first;
 }
 
+template <typename V, typename E>
+std::size_t Graph<V, E>::BFSIterator::depth() const
+{
+	return m_depth;
+}
+
 template <typename V, typename E>
 Graph<V, E>::BFSIterator::BFSIterator(const Graph& graph, std::size_t node)
 	: m_graph{graph}, m_current{node}
 {
 	m_visited.resize(graph.nrOfVertices());
-	m_queue.push(node);
+	m_queue.emplace(node, 0);
 	++*this;
 }
 
@@ -0,0 +1,655 @@
+#ifndef CONTRACTIONHIERARCHY_HPP
+#define CONTRACTIONHIERARCHY_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <istream>
+#include <limits>
+#include <ostream>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "Graph.hpp"
+#include "IndexedHeap.hpp"
+#include "SearchWorkspace.hpp"
+#include "ThreadPool.hpp"
+
+// contraction hierarchy built from a Graph and an edge length function
+// vertices are contracted one by one (lowest edge difference first) and
+// shortcuts keep the distances between the remaining ones, a query is a
+// bidirectional Dijkstra which only goes up the hierarchy
+// the result does not depend on the graph anymore and can be saved to disk
+class ContractionHierarchy {
+public:
+	ContractionHierarchy() = default;
+	ContractionHierarchy(const ContractionHierarchy&) = default;
+	ContractionHierarchy(ContractionHierarchy&&) = default;
+	ContractionHierarchy& operator=(const ContractionHierarchy&) = default;
+	ContractionHierarchy& operator=(ContractionHierarchy&&) = default;
+	~ContractionHierarchy() = default;
+
+	template <typename V, typename E, typename F>
+	static ContractionHierarchy build(const Graph<V, E>&, F);
+
+	std::size_t nrOfVertices() const;
+	// position of the vertex in the contraction order
+	std::size_t rank(std::size_t) const;
+
+	// same result as Graph::dijkstra, shortcuts are unpacked to the original
+	// vertices
+	std::pair<double, std::vector<std::size_t>>
+	query(std::size_t, std::size_t) const;
+	std::pair<double, std::vector<std::size_t>> query(
+		std::size_t,
+		std::size_t,
+		SearchWorkspace<double>&,
+		SearchWorkspace<double>&) const;
+	// same result as Graph::distanceTable, the upward search spaces of the
+	// targets are stored in buckets which are scanned by the upward searches
+	// of the sources, threads (0 - one per hardware thread) are started and
+	// joined by every call, with a pool of the caller they are reused
+	std::vector<double> distanceTable(
+		const std::vector<std::size_t>&,
+		const std::vector<std::size_t>&,
+		std::size_t = 0) const;
+	std::vector<double> distanceTable(
+		const std::vector<std::size_t>&,
+		const std::vector<std::size_t>&,
+		ThreadPool&) const;
+
+	// binary format in native byte order, load() checks that the data forms
+	// a valid hierarchy and throws std::runtime_error otherwise
+	void save(std::ostream&) const;
+	static ContractionHierarchy load(std::istream&);
+
+private:
+	class Contraction;
+
+	static constexpr std::uint32_t NONE
+		= std::numeric_limits<std::uint32_t>::max();
+	static constexpr char MAGIC[4] = {'C', 'H', '0', '1'};
+
+	// edge of the hierarchy, middle is the contracted vertex of a shortcut
+	struct Arc {
+		std::uint32_t node;
+		std::uint32_t middle;
+		double length;
+	};
+
+	// all vertices reachable over upward (or downward, backwards) arcs with
+	// their distances
+	void searchSpace(
+		std::size_t,
+		const std::vector<std::uint64_t>&,
+		const std::vector<Arc>&,
+		SearchWorkspace<double>&,
+		std::vector<std::pair<std::size_t, double>>&) const;
+	const Arc& arc(std::size_t, std::size_t) const;
+	void unpack(std::size_t, std::size_t, std::vector<std::size_t>&) const;
+	bool valid() const;
+
+	template <typename T>
+	static void write(std::ostream&, const std::vector<T>&);
+	template <typename T>
+	static void read(std::istream&, std::vector<T>&);
+
+	std::vector<std::uint32_t> m_rank{};
+	// upward arcs of every vertex
+	std::vector<std::uint64_t> m_up_offsets{0};
+	std::vector<Arc> m_up{};
+	// arcs coming down into every vertex, node is the source
+	std::vector<std::uint64_t> m_down_offsets{0};
+	std::vector<Arc> m_down{};
+};
+
+// state of the remaining graph during preprocessing
+class ContractionHierarchy::Contraction {
+public:
+	explicit Contraction(std::size_t);
+
+	void addArc(std::size_t, std::size_t, double, std::uint32_t);
+	// contracts vertices in order and fills the hierarchy
+	void run(ContractionHierarchy&);
+
+private:
+	// witness searches give up after settling this many vertices
+	static constexpr std::size_t WITNESS_LIMIT = 500;
+
+	struct Shortcut {
+		std::size_t from;
+		std::size_t to;
+		double length;
+	};
+
+	// shortcuts needed to contract the vertex, stored in m_shortcuts
+	void findShortcuts(std::size_t);
+	// edge difference plus contracted neighbours for a uniform order
+	std::ptrdiff_t priority(std::size_t);
+	void contract(std::size_t);
+
+	std::size_t m_vertices;
+	// only not contracted vertices are kept on the lists
+	std::vector<std::vector<Arc>> m_out;
+	std::vector<std::vector<Arc>> m_in;
+	std::vector<std::size_t> m_contracted_neighbours;
+	std::vector<std::vector<Arc>> m_up;
+	std::vector<std::vector<Arc>> m_down;
+	std::vector<Shortcut> m_shortcuts{};
+	SearchWorkspace<double> m_witness{};
+};
+
+////////////////////////////////////////
+// ContractionHierarchy implementation
+////////////////////////////////////////
+
+template <typename V, typename E, typename F>
+ContractionHierarchy ContractionHierarchy::build(const Graph<V, E>& graph, F f)
+{
+	Contraction contraction{graph.nrOfVertices()};
+	for (auto it = graph.beginEdges(); it != graph.endEdges(); ++it) {
+		const auto length = f(*it);
+		if constexpr (std::is_signed_v<EdgeLength<F, E>>)
+			if (length < 0)
+				throw std::domain_error{"Ujemna długość krawędzi"};
+		if (it.v1id() != it.v2id())
+			contraction.addArc(
+				it.v1id(), it.v2id(), static_cast<double>(length), NONE);
+	}
+	ContractionHierarchy out{};
+	contraction.run(out);
+	return out;
+}
+
+inline std::size_t ContractionHierarchy::nrOfVertices() const
+{
+	return m_rank.size();
+}
+
+inline std::size_t ContractionHierarchy::rank(std::size_t node) const
+{
+	return m_rank[node];
+}
+
+inline std::pair<double, std::vector<std::size_t>>
+ContractionHierarchy::query(std::size_t start, std::size_t end) const
+{
+	SearchWorkspace<double> forward{};
+	SearchWorkspace<double> backward{};
+	return query(start, end, forward, backward);
+}
+
+inline std::pair<double, std::vector<std::size_t>> ContractionHierarchy::query(
+	std::size_t start,
+	std::size_t end,
+	SearchWorkspace<double>& forward,
+	SearchWorkspace<double>& backward) const
+{
+	const auto vertices = nrOfVertices();
+	if (start == end)
+		return std::make_pair(0., std::vector<std::size_t>{start});
+
+	forward.reset(vertices);
+	backward.reset(vertices);
+	forward.reach(start, 0, start);
+	forward.heap().push(start, 0);
+	backward.reach(end, 0, end);
+	backward.heap().push(end, 0);
+
+	double best = std::numeric_limits<double>::infinity();
+	std::size_t meeting = vertices;
+	while (true) {
+		// a direction is done once its frontier cannot improve the best path
+		const bool forward_active
+			= !forward.heap().empty() && forward.heap().topKey() < best;
+		const bool backward_active
+			= !backward.heap().empty() && backward.heap().topKey() < best;
+		if (!forward_active && !backward_active)
+			break;
+		const bool go_forward = forward_active
+			&& (!backward_active
+				|| forward.heap().topKey() <= backward.heap().topKey());
+		auto& search = go_forward ? forward : backward;
+		const auto& other = go_forward ? backward : forward;
+		const auto& offsets = go_forward ? m_up_offsets : m_down_offsets;
+		const auto& arcs = go_forward ? m_up : m_down;
+
+		const auto current = search.heap().top();
+		search.heap().pop();
+		search.settle(current);
+		const auto cost = search.distance(current);
+		if (other.reached(current) && cost + other.distance(current) < best) {
+			best = cost + other.distance(current);
+			meeting = current;
+		}
+		for (auto i = offsets[current]; i < offsets[current + 1]; ++i) {
+			const auto& a = arcs[i];
+			if (search.settled(a.node))
+				continue;
+			const auto next = cost + a.length;
+			if (!search.reached(a.node)) {
+				search.reach(a.node, next, current);
+				search.heap().push(a.node, next);
+			} else if (next < search.distance(a.node)) {
+				search.reach(a.node, next, current);
+				search.heap().decrease(a.node, next);
+			}
+		}
+	}
+	if (meeting == vertices)
+		throw std::runtime_error{"No valid path"};
+
+	// path in the hierarchy, then every arc is unpacked
+	auto hierarchy_path = forward.path(meeting);
+	for (auto node = meeting; node != end; node = backward.previous(node))
+		hierarchy_path.push_back(backward.previous(node));
+	std::vector<std::size_t> out{start};
+	for (std::size_t i = 1; i < hierarchy_path.size(); ++i)
+		unpack(hierarchy_path[i - 1], hierarchy_path[i], out);
+	return std::make_pair(best, out);
+}
+
+inline std::vector<double> ContractionHierarchy::distanceTable(
+	const std::vector<std::size_t>& sources,
+	const std::vector<std::size_t>& targets,
+	std::size_t threads) const
+{
+	// no more workers than searches in a phase, but at least one
+	const auto workers = std::min(
+		ThreadPool::threadCount(threads),
+		std::max(sources.size(), targets.size()));
+	ThreadPool pool{std::max<std::size_t>(workers, 1)};
+	return distanceTable(sources, targets, pool);
+}
+
+inline std::vector<double> ContractionHierarchy::distanceTable(
+	const std::vector<std::size_t>& sources,
+	const std::vector<std::size_t>& targets,
+	ThreadPool& pool) const
+{
+	const auto vertices = nrOfVertices();
+	const auto columns = targets.size();
+	std::vector<double> out(
+		sources.size() * columns, std::numeric_limits<double>::infinity());
+	if (out.empty())
+		return out;
+
+	std::vector<SearchWorkspace<double>> workspaces(pool.size());
+
+	std::vector<std::vector<std::pair<std::size_t, double>>> spaces(columns);
+	pool.parallelFor(columns, [&](std::size_t worker, std::size_t j) {
+		searchSpace(
+			targets[j], m_down_offsets, m_down, workspaces[worker], spaces[j]);
+	});
+
+	// bucket of a vertex - (column, distance to the target) pairs
+	std::vector<std::size_t> bucket_offsets(vertices + 1, 0);
+	for (const auto& space : spaces)
+		for (const auto& entry : space)
+			++bucket_offsets[entry.first + 1];
+	for (std::size_t i = 0; i < vertices; ++i)
+		bucket_offsets[i + 1] += bucket_offsets[i];
+	std::vector<std::pair<std::size_t, double>> buckets(
+		bucket_offsets.back());
+	{
+		auto next = bucket_offsets;
+		for (std::size_t j = 0; j < columns; ++j)
+			for (const auto& [node, length] : spaces[j])
+				buckets[next[node]++] = {j, length};
+		spaces.clear();
+	}
+
+	std::vector<std::vector<std::pair<std::size_t, double>>> scratch(
+		pool.size());
+	pool.parallelFor(sources.size(), [&](std::size_t worker, std::size_t i) {
+		auto& space = scratch[worker];
+		searchSpace(sources[i], m_up_offsets, m_up, workspaces[worker], space);
+		auto* row = &out[i * columns];
+		for (const auto& [node, length] : space)
+			for (auto b = bucket_offsets[node]; b < bucket_offsets[node + 1];
+				 ++b) {
+				const auto [column, rest] = buckets[b];
+				row[column] = std::min(row[column], length + rest);
+			}
+	});
+	return out;
+}
+
+inline void ContractionHierarchy::searchSpace(
+	std::size_t source,
+	const std::vector<std::uint64_t>& offsets,
+	const std::vector<Arc>& arcs,
+	SearchWorkspace<double>& workspace,
+	std::vector<std::pair<std::size_t, double>>& out) const
+{
+	out.clear();
+	workspace.reset(nrOfVertices());
+	auto& frontier = workspace.heap();
+	workspace.reach(source, 0, source);
+	frontier.push(source, 0);
+	while (!frontier.empty()) {
+		const auto current = frontier.top();
+		frontier.pop();
+		workspace.settle(current);
+		const auto cost = workspace.distance(current);
+		out.emplace_back(current, cost);
+		for (auto i = offsets[current]; i < offsets[current + 1]; ++i) {
+			const auto& a = arcs[i];
+			if (workspace.settled(a.node))
+				continue;
+			const auto next = cost + a.length;
+			if (!workspace.reached(a.node)) {
+				workspace.reach(a.node, next, current);
+				frontier.push(a.node, next);
+			} else if (next < workspace.distance(a.node)) {
+				workspace.reach(a.node, next, current);
+				frontier.decrease(a.node, next);
+			}
+		}
+	}
+}
+
+inline const ContractionHierarchy::Arc&
+ContractionHierarchy::arc(std::size_t from, std::size_t to) const
+{
+	// an arc is stored at its lower ranked end
+	if (m_rank[from] < m_rank[to]) {
+		for (auto i = m_up_offsets[from]; i < m_up_offsets[from + 1]; ++i)
+			if (m_up[i].node == to)
+				return m_up[i];
+	} else {
+		for (auto i = m_down_offsets[to]; i < m_down_offsets[to + 1]; ++i)
+			if (m_down[i].node == from)
+				return m_down[i];
+	}
+	throw std::logic_error{"Brak krawędzi w hierarchii"};
+}
+
+inline void ContractionHierarchy::unpack(
+	std::size_t from,
+	std::size_t to,
+	std::vector<std::size_t>& out) const
+{
+	// appends the vertices after "from" up to "to"
+	std::vector<std::pair<std::size_t, std::size_t>> stack{{from, to}};
+	while (!stack.empty()) {
+		const auto [first, second] = stack.back();
+		stack.pop_back();
+		const auto middle = arc(first, second).middle;
+		if (middle == NONE) {
+			out.push_back(second);
+			continue;
+		}
+		stack.emplace_back(middle, second);
+		stack.emplace_back(first, middle);
+	}
+}
+
+inline void ContractionHierarchy::save(std::ostream& stream) const
+{
+	stream.write(MAGIC, sizeof(MAGIC));
+	write(stream, m_rank);
+	write(stream, m_up_offsets);
+	write(stream, m_up);
+	write(stream, m_down_offsets);
+	write(stream, m_down);
+	if (!stream)
+		throw std::runtime_error{"Nie udało się zapisać hierarchii"};
+}
+
+inline ContractionHierarchy ContractionHierarchy::load(std::istream& stream)
+{
+	char magic[sizeof(MAGIC)];
+	stream.read(magic, sizeof(magic));
+	if (!stream || !std::equal(magic, magic + sizeof(magic), MAGIC))
+		throw std::runtime_error{"To nie jest plik hierarchii"};
+	ContractionHierarchy out{};
+	read(stream, out.m_rank);
+	read(stream, out.m_up_offsets);
+	read(stream, out.m_up);
+	read(stream, out.m_down_offsets);
+	read(stream, out.m_down);
+	if (!out.valid())
+		throw std::runtime_error{"Uszkodzony plik hierarchii"};
+	return out;
+}
+
+inline bool ContractionHierarchy::valid() const
+{
+	// ranks are a permutation
+	const auto vertices = m_rank.size();
+	std::vector<bool> used(vertices);
+	for (auto r : m_rank) {
+		if (r >= vertices || used[r])
+			return false;
+		used[r] = true;
+	}
+
+	// every arc leads to a higher ranked vertex and a shortcut goes over a
+	// vertex ranked below both its ends, so queries and unpacking end
+	const auto check = [&](const std::vector<std::uint64_t>& offsets,
+						   const std::vector<Arc>& arcs) {
+		if (offsets.size() != vertices + 1 || offsets.front() != 0
+			|| offsets.back() != arcs.size())
+			return false;
+		for (std::size_t i = 0; i < vertices; ++i) {
+			if (offsets[i] > offsets[i + 1])
+				return false;
+			for (auto j = offsets[i]; j < offsets[i + 1]; ++j) {
+				const auto& a = arcs[j];
+				if (a.node >= vertices || m_rank[a.node] <= m_rank[i])
+					return false;
+				if (a.middle != NONE
+					&& (a.middle >= vertices
+						|| m_rank[a.middle] >= m_rank[i]))
+					return false;
+			}
+		}
+		return true;
+	};
+	return check(m_up_offsets, m_up) && check(m_down_offsets, m_down);
+}
+
+template <typename T>
+void ContractionHierarchy::write(
+	std::ostream& stream,
+	const std::vector<T>& data)
+{
+	const std::uint64_t size = data.size();
+	stream.write(reinterpret_cast<const char*>(&size), sizeof(size));
+	stream.write(
+		reinterpret_cast<const char*>(data.data()),
+		static_cast<std::streamsize>(data.size() * sizeof(T)));
+}
+
+template <typename T>
+void ContractionHierarchy::read(std::istream& stream, std::vector<T>& data)
+{
+	std::uint64_t size{0};
+	stream.read(reinterpret_cast<char*>(&size), sizeof(size));
+	if (!stream)
+		throw std::runtime_error{"Uszkodzony plik hierarchii"};
+	// the size is not trusted before it is compared with the rest of a
+	// seekable stream
+	const auto position = stream.tellg();
+	if (position != std::istream::pos_type(-1)) {
+		stream.seekg(0, std::ios::end);
+		const auto rest = static_cast<std::uint64_t>(stream.tellg() - position);
+		stream.seekg(position);
+		if (size > rest / sizeof(T))
+			throw std::runtime_error{"Uszkodzony plik hierarchii"};
+	}
+	data.resize(size);
+	stream.read(
+		reinterpret_cast<char*>(data.data()),
+		static_cast<std::streamsize>(size * sizeof(T)));
+	if (!stream)
+		throw std::runtime_error{"Uszkodzony plik hierarchii"};
+}
+
+////////////////////////////////////////
+// Contraction implementation
+////////////////////////////////////////
+
+inline ContractionHierarchy::Contraction::Contraction(std::size_t vertices)
+	: m_vertices{vertices}
+	, m_out(vertices)
+	, m_in(vertices)
+	, m_contracted_neighbours(vertices)
+	, m_up(vertices)
+	, m_down(vertices)
+{
+}
+
+inline void ContractionHierarchy::Contraction::addArc(
+	std::size_t from,
+	std::size_t to,
+	double length,
+	std::uint32_t middle)
+{
+	const auto to_id = static_cast<std::uint32_t>(to);
+	const auto from_id = static_cast<std::uint32_t>(from);
+	auto& list = m_out[from];
+	auto it = std::find_if(list.begin(), list.end(), [to_id](const Arc& a) {
+		return a.node == to_id;
+	});
+	if (it == list.end()) {
+		list.push_back({to_id, middle, length});
+		m_in[to].push_back({from_id, middle, length});
+		return;
+	}
+	// parallel arcs are merged, the shorter one stays
+	if (it->length <= length)
+		return;
+	*it = {to_id, middle, length};
+	for (auto& a : m_in[to])
+		if (a.node == from_id)
+			a = {from_id, middle, length};
+}
+
+inline void ContractionHierarchy::Contraction::findShortcuts(std::size_t node)
+{
+	m_shortcuts.clear();
+	for (const auto& incoming : m_in[node]) {
+		const std::size_t source = incoming.node;
+		double limit = -1;
+		for (const auto& outgoing : m_out[node])
+			if (outgoing.node != source)
+				limit = std::max(limit, incoming.length + outgoing.length);
+		if (limit < 0)
+			continue;
+
+		// local Dijkstra from the source avoiding the vertex
+		m_witness.reset(m_vertices);
+		auto& frontier = m_witness.heap();
+		m_witness.reach(source, 0, source);
+		frontier.push(source, 0);
+		std::size_t settled = 0;
+		while (!frontier.empty() && settled < WITNESS_LIMIT) {
+			const auto current = frontier.top();
+			const auto cost = m_witness.distance(current);
+			if (cost > limit)
+				break;
+			frontier.pop();
+			m_witness.settle(current);
+			++settled;
+			for (const auto& a : m_out[current]) {
+				if (a.node == node || m_witness.settled(a.node))
+					continue;
+				const auto next = cost + a.length;
+				if (!m_witness.reached(a.node)) {
+					m_witness.reach(a.node, next, current);
+					frontier.push(a.node, next);
+				} else if (next < m_witness.distance(a.node)) {
+					m_witness.reach(a.node, next, current);
+					frontier.decrease(a.node, next);
+				}
+			}
+		}
+
+		// a found path does not have to be the shortest one to be a witness
+		for (const auto& outgoing : m_out[node]) {
+			if (outgoing.node == source)
+				continue;
+			const auto via = incoming.length + outgoing.length;
+			if (m_witness.reached(outgoing.node)
+				&& m_witness.distance(outgoing.node) <= via)
+				continue;
+			m_shortcuts.push_back({source, outgoing.node, via});
+		}
+	}
+}
+
+inline std::ptrdiff_t
+ContractionHierarchy::Contraction::priority(std::size_t node)
+{
+	findShortcuts(node);
+	const auto removed = m_in[node].size() + m_out[node].size();
+	return static_cast<std::ptrdiff_t>(
+			   m_shortcuts.size() + m_contracted_neighbours[node])
+		- static_cast<std::ptrdiff_t>(removed);
+}
+
+inline void ContractionHierarchy::Contraction::contract(std::size_t node)
+{
+	const auto id = static_cast<std::uint32_t>(node);
+	const auto drop = [id](std::vector<Arc>& list) {
+		list.erase(
+			std::remove_if(
+				list.begin(),
+				list.end(),
+				[id](const Arc& a) { return a.node == id; }),
+			list.end());
+	};
+	// the remaining arcs lead to higher ranked vertices
+	for (const auto& a : m_out[node]) {
+		drop(m_in[a.node]);
+		++m_contracted_neighbours[a.node];
+	}
+	for (const auto& a : m_in[node]) {
+		drop(m_out[a.node]);
+		++m_contracted_neighbours[a.node];
+	}
+	m_up[node] = std::move(m_out[node]);
+	m_down[node] = std::move(m_in[node]);
+	m_out[node].clear();
+	m_in[node].clear();
+	for (const auto& shortcut : m_shortcuts)
+		addArc(shortcut.from, shortcut.to, shortcut.length, id);
+}
+
+inline void ContractionHierarchy::Contraction::run(
+	ContractionHierarchy& hierarchy)
+{
+	IndexedHeap<std::ptrdiff_t> queue{};
+	queue.clear(m_vertices);
+	for (std::size_t i = 0; i < m_vertices; ++i)
+		queue.push(i, priority(i));
+
+	hierarchy.m_rank.assign(m_vertices, NONE);
+	std::uint32_t next_rank{0};
+	while (!queue.empty()) {
+		const auto node = queue.top();
+		queue.pop();
+		// lazy update, the priority may have grown since it was computed
+		const auto current = priority(node);
+		if (!queue.empty() && current > queue.topKey()) {
+			queue.push(node, current);
+			continue;
+		}
+		hierarchy.m_rank[node] = next_rank++;
+		contract(node);
+	}
+
+	for (std::size_t i = 0; i < m_vertices; ++i) {
+		hierarchy.m_up.insert(
+			hierarchy.m_up.end(), m_up[i].begin(), m_up[i].end());
+		hierarchy.m_up_offsets.push_back(hierarchy.m_up.size());
+		hierarchy.m_down.insert(
+			hierarchy.m_down.end(), m_down[i].begin(), m_down[i].end());
+		hierarchy.m_down_offsets.push_back(hierarchy.m_down.size());
+	}
+}
+
+#endif /* CONTRACTIONHIERARCHY_HPP */
@@ -11,6 +11,9 @@ class Graph<V, E>::DFSIterator {
 	friend class Graph<V, E>;
 
 public:
+	// events reported by step()
+	enum class Event { DISCOVER, FINISH, END };
+
 	DFSIterator(const DFSIterator&) = default;
 	DFSIterator(DFSIterator&&) = default;
 	DFSIterator& operator=(const DFSIterator&) = default;
@@ -26,13 +29,22 @@ public:
 	const V& operator*() const;
 	V* operator->() const;
 
+	// id of the vertex of the last event
+	std::size_t id() const;
+	// number of vertices on the current DFS path
+	std::size_t depth() const;
+	// advances to the next discovery or finish event, the start vertex is
+	// discovered on construction
+	Event step();
+
 private:
 	DFSIterator(const Graph& graph, std::size_t node);
 	DFSIterator(const Graph& graph);
 
 	const Graph& m_graph;
 	std::size_t m_current{0};
-	std::stack<std::size_t> m_stack{};
+	// (vertex, next neighbour to scan) - at most one entry per vertex
+	std::vector<std::pair<std::size_t, std::size_t>> m_stack{};
 	std::vector<bool> m_visited{};
 };
 
@@ -52,26 +64,43 @@ bool Graph<V, E>::DFSIterator::operator!=(const DFSIterator& rhs) const
 	return !(*this == rhs);
 }
 
+template <typename V, typename E>
+typename Graph<V, E>::DFSIterator::Event Graph<V, E>::DFSIterator::step()
+{
+	if (m_stack.empty()) {
+		m_current = m_graph.nrOfVertices();
+		return Event::END;
+	}
+
+	auto& [node, next] = m_stack.back();
+	const auto& row = m_graph.m_data[node].second;
+	// resume scanning where the previous step stopped
+	while (next < row.size()) {
+		const auto i = next++;
+		if (!row[i].has_value() || m_visited[i])
+			continue;
+		m_visited[i] = true;
+		m_stack.emplace_back(i, 0);
+		m_current = i;
+		return Event::DISCOVER;
+	}
+	m_current = node;
+	m_stack.pop_back();
+	return Event::FINISH;
+}
+
 template <typename V, typename E>
 typename Graph<V, E>::DFSIterator& Graph<V, E>::DFSIterator::operator++()
 {
-	std::size_t tmp;
-	do {
-		if (m_stack.empty()) {
-			m_current = m_graph.nrOfVertices();
+	while (true) {
+		switch (step()) {
+		case Event::DISCOVER:
+		case Event::END:
 			return *this;
-		}
-		tmp = m_stack.top();
-		m_stack.pop();
-	} while (m_visited[tmp]);
-	m_visited[tmp] = true;
-	for (std::size_t i = m_graph.m_data[tmp].second.size(); i > 0; --i) {
-		if (m_graph.edgeExist(tmp, i - 1)) {
-			m_stack.push(i - 1);
+		case Event::FINISH:
+			break;
 		}
 	}
-	m_current = tmp;
-	return *this;
 }
 
 template <typename V, typename E>
@@ -94,13 +123,25 @@ V* Graph<V, E>::DFSIterator::operator->() const
 	return m_graph.m_data[m_current].first;
 }
 
+template <typename V, typename E>
+std::size_t Graph<V, E>::DFSIterator::id() const
+{
+	return m_current;
+}
+
+template <typename V, typename E>
+std::size_t Graph<V, E>::DFSIterator::depth() const
+{
+	return m_stack.size();
+}
+
 template <typename V, typename E>
 Graph<V, E>::DFSIterator::DFSIterator(const Graph& graph, std::size_t node)
 	: m_graph{graph}, m_current{node}
 {
 	m_visited.resize(graph.nrOfVertices());
-	m_stack.push(node);
-	++*this;
+	m_visited[node] = true;
+	m_stack.emplace_back(node, 0);
 }
 
 template <typename V, typename E>
@@ -0,0 +1,238 @@
+#ifndef DYNAMICSHORTESTPATHS_HPP
+#define DYNAMICSHORTESTPATHS_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "Graph.hpp"
+#include "IndexedHeap.hpp"
+
+// shortest path tree from one source kept up to date while edges change
+// (Ramalingam-Reps): after a change of edge (u, v) - a new length, insertion
+// or removal - update(u, v) repairs only the vertices whose distance or
+// parent has to change, for example:
+//     graph.setEdgeLabel(u, v, 7);
+//     tree.update(u, v);
+// the graph is read through the reference, its set of vertices must not
+// change
+template <typename V, typename E, typename F>
+class DynamicShortestPaths {
+public:
+	DynamicShortestPaths(const Graph<V, E>&, std::size_t, F);
+	DynamicShortestPaths(const DynamicShortestPaths&) = default;
+	DynamicShortestPaths(DynamicShortestPaths&&) = default;
+	DynamicShortestPaths& operator=(const DynamicShortestPaths&) = delete;
+	DynamicShortestPaths& operator=(DynamicShortestPaths&&) = delete;
+	~DynamicShortestPaths() = default;
+
+	std::size_t source() const;
+	// infinity if unreachable
+	double distance(std::size_t) const;
+	// nrOfVertices() if unreachable, the source is its own parent
+	std::size_t parent(std::size_t) const;
+	// from the source to the vertex, throws if unreachable
+	std::vector<std::size_t> path(std::size_t) const;
+
+	// to be called once for every edge which changed, after the change
+	void update(std::size_t, std::size_t);
+	// number of vertices whose distance was recomputed by the last update
+	std::size_t lastRepairSize() const;
+
+private:
+	static constexpr double INF = std::numeric_limits<double>::infinity();
+
+	// infinity if there is no edge
+	double length(std::size_t, std::size_t) const;
+	// the edge got shorter (or new), improvements spread from its end
+	void decrease(std::size_t, std::size_t, double);
+	// a tree edge got longer (or removed), its subtree is recomputed
+	void increase(std::size_t);
+	// Dijkstra from the vertices in the heap, when several edges changed at
+	// once a recomputed subtree can also improve vertices outside of it
+	void propagate();
+
+	const Graph<V, E>& m_graph;
+	std::size_t m_source;
+	F m_f;
+	std::vector<double> m_distance;
+	std::vector<std::size_t> m_parent;
+	// scratch of the repairs
+	IndexedHeap<double> m_heap{};
+	std::vector<char> m_affected{};
+	std::vector<std::size_t> m_subtree{};
+	std::size_t m_last_repair{0};
+};
+
+////////////////////////////////////////
+// DynamicShortestPaths implementation
+////////////////////////////////////////
+
+template <typename V, typename E, typename F>
+DynamicShortestPaths<V, E, F>::DynamicShortestPaths(
+	const Graph<V, E>& graph,
+	std::size_t source,
+	F f)
+	: m_graph{graph}
+	, m_source{source}
+	, m_f{f}
+	, m_distance{}
+	, m_parent{}
+{
+	auto tree = graph.shortestPathTree(source, f);
+	m_distance = std::move(tree.distance);
+	m_parent = std::move(tree.parent);
+	m_affected.assign(m_distance.size(), 0);
+}
+
+template <typename V, typename E, typename F>
+std::size_t DynamicShortestPaths<V, E, F>::source() const
+{
+	return m_source;
+}
+
+template <typename V, typename E, typename F>
+double DynamicShortestPaths<V, E, F>::distance(std::size_t node) const
+{
+	return m_distance[node];
+}
+
+template <typename V, typename E, typename F>
+std::size_t DynamicShortestPaths<V, E, F>::parent(std::size_t node) const
+{
+	return m_parent[node];
+}
+
+template <typename V, typename E, typename F>
+std::vector<std::size_t>
+DynamicShortestPaths<V, E, F>::path(std::size_t node) const
+{
+	if (m_distance[node] == INF)
+		throw std::runtime_error{"No valid path"};
+	std::vector<std::size_t> out{node};
+	for (; node != m_source; node = m_parent[node])
+		out.push_back(m_parent[node]);
+	std::reverse(out.begin(), out.end());
+	return out;
+}
+
+template <typename V, typename E, typename F>
+void DynamicShortestPaths<V, E, F>::update(std::size_t from, std::size_t to)
+{
+	if (m_graph.nrOfVertices() != m_distance.size())
+		throw std::logic_error{"Zmieniono zbiór wierzchołków"};
+	m_last_repair = 0;
+	// a self-loop is never on a shortest path
+	if (from == to || m_distance[from] == INF)
+		return;
+	const auto cost = m_distance[from] + length(from, to);
+	if (cost < m_distance[to])
+		decrease(from, to, cost);
+	else if (m_parent[to] == from && cost > m_distance[to])
+		increase(to);
+}
+
+template <typename V, typename E, typename F>
+std::size_t DynamicShortestPaths<V, E, F>::lastRepairSize() const
+{
+	return m_last_repair;
+}
+
+template <typename V, typename E, typename F>
+double DynamicShortestPaths<V, E, F>::length(std::size_t from, std::size_t to)
+	const
+{
+	using Length = EdgeLength<F, E>;
+	if (!m_graph.edgeExist(from, to))
+		return INF;
+	const Length value = m_f(m_graph.edgeLabel(from, to));
+	if constexpr (std::is_signed_v<Length>)
+		if (value < 0)
+			throw std::domain_error{"Ujemna długość krawędzi"};
+	return static_cast<double>(value);
+}
+
+template <typename V, typename E, typename F>
+void DynamicShortestPaths<V, E, F>::decrease(
+	std::size_t from,
+	std::size_t to,
+	double cost)
+{
+	const auto vertices = m_distance.size();
+	m_heap.clear(vertices);
+	m_distance[to] = cost;
+	m_parent[to] = from;
+	m_heap.push(to, cost);
+	propagate();
+}
+
+template <typename V, typename E, typename F>
+void DynamicShortestPaths<V, E, F>::increase(std::size_t root)
+{
+	const auto vertices = m_distance.size();
+	// the subtree hanging from the changed edge
+	m_subtree.assign(1, root);
+	m_affected[root] = 1;
+	for (std::size_t q = 0; q < m_subtree.size(); ++q) {
+		const auto current = m_subtree[q];
+		for (std::size_t i = 0; i < vertices; ++i)
+			// the tree edge may be gone already, with its update pending
+			if (!m_affected[i] && m_parent[i] == current) {
+				m_affected[i] = 1;
+				m_subtree.push_back(i);
+			}
+	}
+	m_last_repair = m_subtree.size();
+
+	// the best way into the subtree from the rest of the tree, which did not
+	// change, then Dijkstra from the subtree
+	m_heap.clear(vertices);
+	for (const auto node : m_subtree) {
+		m_distance[node] = INF;
+		m_parent[node] = vertices;
+		for (std::size_t i = 0; i < vertices; ++i) {
+			if (m_affected[i] || m_distance[i] == INF)
+				continue;
+			const auto cost = m_distance[i] + length(i, node);
+			if (cost < m_distance[node]) {
+				m_distance[node] = cost;
+				m_parent[node] = i;
+			}
+		}
+		if (m_distance[node] != INF)
+			m_heap.push(node, m_distance[node]);
+	}
+	propagate();
+	for (const auto node : m_subtree)
+		m_affected[node] = 0;
+}
+
+template <typename V, typename E, typename F>
+void DynamicShortestPaths<V, E, F>::propagate()
+{
+	const auto vertices = m_distance.size();
+	while (!m_heap.empty()) {
+		const auto current = m_heap.top();
+		m_heap.pop();
+		// vertices of a recomputed subtree are already counted
+		if (!m_affected[current])
+			++m_last_repair;
+		for (std::size_t i = 0; i < vertices; ++i) {
+			const auto next = m_distance[current] + length(current, i);
+			if (!(next < m_distance[i]))
+				continue;
+			m_distance[i] = next;
+			m_parent[i] = current;
+			if (m_heap.contains(i))
+				m_heap.decrease(i, next);
+			else
+				m_heap.push(i, next);
+		}
+	}
+}
+
+#endif /* DYNAMICSHORTESTPATHS_HPP */
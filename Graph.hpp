@@ -3,17 +3,31 @@
 #define GRAPH_HPP
 
 #include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
 #include <cstdint>
 #include <functional>
 #include <iomanip>
 #include <iostream>
 #include <limits>
+#include <map>
 #include <optional>
 #include <queue>
+#include <set>
 #include <stack>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
 #include <unordered_map>
 #include <vector>
 
+#include "GraphVisitor.hpp"
+#include "IndexedHeap.hpp"
+#include "LazyHeap.hpp"
+#include "SearchWorkspace.hpp"
+#include "ThreadPool.hpp"
+
 #define A_STAR_SHOW_VISITS 0
 #define USE_FASTER_REMOVAL 0
 
@@ -28,6 +42,30 @@ public:
 	class EdgesIterator;
 	class BFSIterator;
 	class DFSIterator;
+	class TopologicalOrder;
+	class ReachabilityIndex;
+
+	// vertices near each seed in BFS order, seed i owns
+	// vertices[offsets[i]] .. vertices[offsets[i + 1] - 1]
+	struct Neighborhoods {
+		std::vector<std::size_t> offsets{};
+		std::vector<std::size_t> vertices{};
+	};
+
+	// result of a one-to-all search, vertices outside the tree have infinite
+	// distance and parent nrOfVertices(), the source is its own parent
+	struct ShortestPathTree {
+		std::vector<double> distance{};
+		std::vector<std::size_t> parent{};
+	};
+
+	// result of a bounded-suboptimal search, the length is at most bound
+	// times the length of a shortest path
+	struct BoundedPath {
+		double length{0};
+		std::vector<std::size_t> path{};
+		double bound{1};
+	};
 
 public:
 	Graph() = default;
@@ -54,26 +92,169 @@ public:
 	EdgesIterator edge(std::size_t, std::size_t) const;
 	bool edgeExist(std::size_t, std::size_t) const;
 	const E& edgeLabel(std::size_t, std::size_t) const;
+	// writes through the reference do not change version(), labels read by
+	// cached or incremental searches have to be changed with setEdgeLabel
 	E& edgeLabel(std::size_t, std::size_t);
+	// throws logic_error if there is no such edge
+	void setEdgeLabel(std::size_t, std::size_t, const E&);
 	std::pair<EdgesIterator, bool>
 	insertEdge(std::size_t, std::size_t, const E& = E(), bool = true);
 	bool removeEdge(std::size_t, std::size_t);
 
+	// changes with every modification made by insertVertex, removeVertex,
+	// insertEdge, removeEdge and setEdgeLabel
+	std::uint64_t version() const;
+
+	// in DAG mode a topological order is maintained and insertEdge rejects
+	// edges which would close a cycle
+	bool enableDagMode();
+	void disableDagMode();
+	bool dagMode() const;
+	const TopologicalOrder& topologicalOrder() const;
+
+	// the index is kept up to date by insertEdge when possible and dropped by
+	// other modifications, without it reachable() runs a BFS
+	void buildReachabilityIndex();
+	// bit matrix up to matrix_limit vertices, interval labelling above it
+	void buildReachabilityIndex(std::size_t matrix_limit);
+	bool hasReachabilityIndex() const;
+	bool reachable(std::size_t, std::size_t) const;
+
 	void printNeighborhoodMatrix() const;
 
 	void bfs(std::size_t) const;
 	void dfs(std::size_t) const;
 
+	// traversals calling the hooks of a GraphVisitor, return false if a hook
+	// stopped the traversal
+	template <typename Visitor>
+	bool bfsVisit(std::size_t, Visitor&&) const;
+	template <typename Visitor>
+	bool dfsVisit(std::size_t, Visitor&&) const;
+
+	// vertices within k hops of every seed, seeds are split between threads
+	// (0 - one per hardware thread), which are started and joined by every
+	// call, with a pool of the caller they are reused
+	Neighborhoods kHopNeighborhoods(
+		const std::vector<std::size_t>&,
+		std::size_t,
+		std::size_t = 0) const;
+	Neighborhoods kHopNeighborhoods(
+		const std::vector<std::size_t>&,
+		std::size_t,
+		ThreadPool&) const;
+
 	BFSIterator beginBFS(std::size_t = 0) const;
 	BFSIterator endBFS() const;
 
 	DFSIterator beginDFS(std::size_t = 0) const;
 	DFSIterator endDFS() const;
 
+	// a negative edge length throws domain_error, bellmanFord allows them
 	std::pair<double, std::vector<std::size_t>> dijkstra(
 		const std::size_t,
 		const std::size_t,
 		const std::function<double(const E&)>) const;
+	// any edge length functor, integral lengths select a radix heap
+	template <typename F>
+	std::pair<double, std::vector<std::size_t>>
+	dijkstra(const std::size_t, const std::size_t, F) const;
+	// the workspace can be reused between calls to avoid allocations, its heap
+	// type (IndexedHeap, LazyHeap, RadixHeap, ...) selects the frontier
+	template <typename F, typename Cost, typename Heap>
+	std::pair<double, std::vector<std::size_t>> dijkstra(
+		const std::size_t,
+		const std::size_t,
+		F,
+		SearchWorkspace<Cost, Heap>&) const;
+	// searches from both ends at once, the backward search follows in-edges
+	template <typename F>
+	std::pair<double, std::vector<std::size_t>> bidirectionalDijkstra(
+		const std::size_t,
+		const std::size_t,
+		F) const;
+	template <typename F, typename Heap>
+	std::pair<double, std::vector<std::size_t>> bidirectionalDijkstra(
+		const std::size_t,
+		const std::size_t,
+		F,
+		SearchWorkspace<double, Heap>&,
+		SearchWorkspace<double, Heap>&) const;
+	// Dijkstra from the source to every vertex within the radius
+	template <typename F>
+	ShortestPathTree shortestPathTree(
+		const std::size_t,
+		F,
+		const double = std::numeric_limits<double>::infinity()) const;
+	// stops as soon as all the targets are in the tree
+	template <typename F>
+	ShortestPathTree shortestPathTree(
+		const std::size_t,
+		F,
+		const std::vector<std::size_t>&) const;
+	// distances from every source to every target in a row-major matrix
+	// (infinity - no path), one search per source, sources are split between
+	// threads (0 - one per hardware thread), which are started and joined by
+	// every call, with a pool of the caller they are reused
+	template <typename F>
+	std::vector<double> distanceTable(
+		const std::vector<std::size_t>&,
+		const std::vector<std::size_t>&,
+		F,
+		std::size_t = 0) const;
+	template <typename F>
+	std::vector<double> distanceTable(
+		const std::vector<std::size_t>&,
+		const std::vector<std::size_t>&,
+		F,
+		ThreadPool&) const;
+	// parallel one-to-all distances (infinity - unreachable), buckets of the
+	// given width are settled one after another, edges of a bucket are
+	// relaxed by all threads (0 - one per hardware thread) at once, they are
+	// started and joined by every call, with a pool of the caller they are
+	// reused between queries
+	template <typename F>
+	std::vector<double> deltaStepping(
+		const std::size_t,
+		F,
+		const double,
+		std::size_t = 0) const;
+	template <typename F>
+	std::vector<double> deltaStepping(
+		const std::size_t,
+		F,
+		const double,
+		ThreadPool&) const;
+	// negative lengths allowed, a reachable negative cycle throws
+	// domain_error, rounds relax the edges of vertices improved by the
+	// previous round (as in SPFA) in parallel, several sources start at 0
+	// threads (0 - one per hardware thread) are started and joined by every
+	// call, with a pool of the caller they are reused
+	template <typename F>
+	ShortestPathTree
+	bellmanFord(const std::size_t, F, std::size_t = 0) const;
+	template <typename F>
+	ShortestPathTree bellmanFord(const std::size_t, F, ThreadPool&) const;
+	template <typename F>
+	ShortestPathTree bellmanFord(
+		const std::vector<std::size_t>&,
+		F,
+		std::size_t = 0) const;
+	template <typename F>
+	ShortestPathTree bellmanFord(
+		const std::vector<std::size_t>&,
+		F,
+		ThreadPool&) const;
+	// up to k shortest loopless paths in order of length (Yen), fewer if
+	// there are not so many, the graph is not modified: spur searches mask
+	// vertices and edges, A* in them uses the exact distances to the end
+	// from one backward search
+	template <typename F>
+	std::vector<std::pair<double, std::vector<std::size_t>>> kShortestPaths(
+		const std::size_t,
+		const std::size_t,
+		const std::size_t,
+		F) const;
 	std::pair<double, std::vector<std::size_t>> a_star(
 		const std::size_t,
 		const std::size_t,
@@ -81,9 +262,66 @@ public:
 		const std::function<
 			double(const Graph<V, E>&, const std::size_t, const std::size_t)>)
 		const;
+	// bidirectional A* with averaged potentials, the heuristic must be
+	// consistent and is also called as h(graph, start, vertex) for the backward
+	// search
+	template <typename F, typename H>
+	std::pair<double, std::vector<std::size_t>>
+	bidirectionalAStar(const std::size_t, const std::size_t, F, H) const;
+	template <typename Heap>
+	std::pair<double, std::vector<std::size_t>> a_star(
+		const std::size_t,
+		const std::size_t,
+		const std::function<double(const E&)>,
+		const std::function<
+			double(const Graph<V, E>&, const std::size_t, const std::size_t)>,
+		SearchWorkspace<double, Heap>&) const;
+	// A* with the heuristic weighted by epsilon >= 1: usually far fewer
+	// vertices are expanded and the path is at most epsilon times too long,
+	// the heuristic must be consistent, the reported bound can be lower than
+	// epsilon when the search proves it
+	template <typename F, typename H>
+	BoundedPath weightedAStar(
+		const std::size_t,
+		const std::size_t,
+		F,
+		H,
+		const double) const;
+	// anytime A* (ARA*): the first weighted search always finishes, then the
+	// weight goes down towards 1 and every search reuses the previous one,
+	// until the path is proven shortest, the deadline passes or the number
+	// of expanded vertices reaches the limit, returns the best path found
+	template <typename F, typename H>
+	BoundedPath anytimeAStar(
+		const std::size_t,
+		const std::size_t,
+		F,
+		H,
+		const double,
+		const std::chrono::steady_clock::time_point,
+		const std::size_t = std::numeric_limits<std::size_t>::max()) const;
 
 private:
+	// seeds of kHopNeighborhoods handled by one task
+	static constexpr std::size_t NEIGHBORHOOD_BLOCK = 64;
+
+	template <typename F, typename P, typename Heap>
+	std::pair<double, std::vector<std::size_t>> bidirectionalSearch(
+		const std::size_t,
+		const std::size_t,
+		F,
+		P,
+		SearchWorkspace<double, Heap>&,
+		SearchWorkspace<double, Heap>&) const;
+	// Dijkstra calling visit(vertex, distance) for every settled vertex in
+	// order, stops when it returns false
+	template <typename F, typename Workspace, typename Visit>
+	void settleFrom(const std::size_t, F, Workspace&, Visit) const;
+
 	std::vector<std::pair<V, std::vector<std::optional<E>>>> m_data{};
+	std::optional<TopologicalOrder> m_topological_order{};
+	std::optional<ReachabilityIndex> m_reachability_index{};
+	std::uint64_t m_version{0};
 };
 
 ////////////////////////////////////////
@@ -93,6 +331,8 @@ private:
 #include "BFSIterator.hpp"
 #include "DFSIterator.hpp"
 #include "EdgesIterator.hpp"
+#include "ReachabilityIndex.hpp"
+#include "TopologicalOrder.hpp"
 #include "VerticesIterator.hpp"
 
 ////////////////////////////////////////
@@ -159,6 +399,10 @@ Graph<V, E>::insertVertex(const V& vertex_data)
 	}
 	m_data.push_back(std::make_pair(
 		vertex_data, std::vector<std::optional<E>>(m_data.size() + 1)));
+	if (m_topological_order)
+		m_topological_order->insertVertex();
+	m_reachability_index.reset();
+	++m_version;
 
 	return VerticesIterator(*this, m_data.size() - 1);
 }
@@ -170,6 +414,10 @@ bool Graph<V, E>::removeVertex(std::size_t vertex_id)
 		// throw std::out_of_range{"Index out of range"};
 		return false;
 
+	if (m_topological_order)
+		m_topological_order->removeVertex(vertex_id);
+	m_reachability_index.reset();
+	++m_version;
 	using std::swap;
 #if USE_FASTER_REMOVAL
 	swap(m_data[vertex_id], m_data.back());
@@ -237,6 +485,18 @@ E& Graph<V, E>::edgeLabel(std::size_t vertex1_id, std::size_t vertex2_id)
 	return *m_data[vertex1_id].second[vertex2_id];
 }
 
+template <typename V, typename E>
+void Graph<V, E>::setEdgeLabel(
+	std::size_t vertex1_id,
+	std::size_t vertex2_id,
+	const E& label)
+{
+	if (!edgeExist(vertex1_id, vertex2_id))
+		throw std::logic_error{"Podana krawędź nie istnieje"};
+	*m_data[vertex1_id].second[vertex2_id] = label;
+	++m_version;
+}
+
 template <typename V, typename E>
 bool Graph<V, E>::edgeExist(std::size_t vertex1_id, std::size_t vertex2_id)
 	const
@@ -251,9 +511,17 @@ std::pair<typename Graph<V, E>::EdgesIterator, bool> Graph<V, E>::insertEdge(
 	const E& label,
 	bool replace)
 {
-	if (edgeExist(vertex1_id, vertex2_id) && !replace)
+	const bool exists = edgeExist(vertex1_id, vertex2_id);
+	if (exists && !replace)
+		return std::make_pair(EdgesIterator{*this, 0, 0}, false);
+	if (!exists && m_topological_order
+		&& !m_topological_order->insertEdge(*this, vertex1_id, vertex2_id))
 		return std::make_pair(EdgesIterator{*this, 0, 0}, false);
+	if (!exists && m_reachability_index
+		&& !m_reachability_index->insertEdge(vertex1_id, vertex2_id))
+		m_reachability_index.reset();
 	m_data[vertex1_id].second[vertex2_id] = label;
+	++m_version;
 	return std::make_pair(EdgesIterator{*this, vertex1_id, vertex2_id}, true);
 }
 
@@ -269,9 +537,85 @@ bool Graph<V, E>::removeEdge(std::size_t vertex1_id, std::size_t vertex2_id)
 	if (!tmp.has_value())
 		return false;
 	tmp.reset();
+	m_reachability_index.reset();
+	++m_version;
 	return true;
 }
 
+template <typename V, typename E>
+std::uint64_t Graph<V, E>::version() const
+{
+	return m_version;
+}
+
+template <typename V, typename E>
+bool Graph<V, E>::enableDagMode()
+{
+	TopologicalOrder order{};
+	if (!order.build(*this))
+		return false;
+	m_topological_order = std::move(order);
+	return true;
+}
+
+template <typename V, typename E>
+void Graph<V, E>::disableDagMode()
+{
+	m_topological_order.reset();
+}
+
+template <typename V, typename E>
+bool Graph<V, E>::dagMode() const
+{
+	return m_topological_order.has_value();
+}
+
+template <typename V, typename E>
+const typename Graph<V, E>::TopologicalOrder&
+Graph<V, E>::topologicalOrder() const
+{
+	if (!m_topological_order)
+		throw std::logic_error{"Graf nie jest w trybie DAG"};
+	return *m_topological_order;
+}
+
+template <typename V, typename E>
+void Graph<V, E>::buildReachabilityIndex()
+{
+	buildReachabilityIndex(ReachabilityIndex::MATRIX_LIMIT);
+}
+
+template <typename V, typename E>
+void Graph<V, E>::buildReachabilityIndex(std::size_t matrix_limit)
+{
+	ReachabilityIndex index{};
+	index.build(*this, matrix_limit);
+	m_reachability_index = std::move(index);
+}
+
+template <typename V, typename E>
+bool Graph<V, E>::hasReachabilityIndex() const
+{
+	return m_reachability_index.has_value();
+}
+
+template <typename V, typename E>
+bool Graph<V, E>::reachable(std::size_t vertex1_id, std::size_t vertex2_id)
+	const
+{
+	if (m_reachability_index)
+		return m_reachability_index->reachable(vertex1_id, vertex2_id);
+
+	struct Search : GraphVisitor {
+		std::size_t target;
+		bool discover_vertex(std::size_t node, const Graph&)
+		{
+			return node != target;
+		}
+	};
+	return !bfsVisit(vertex1_id, Search{{}, vertex2_id});
+}
+
 template <typename V, typename E>
 void Graph<V, E>::printNeighborhoodMatrix() const
 {
@@ -296,45 +640,178 @@ void Graph<V, E>::printNeighborhoodMatrix() const
 template <typename V, typename E>
 void Graph<V, E>::bfs(std::size_t start) const
 {
-	std::vector<bool> visited(m_data.size());
-	std::queue<std::size_t> queue{};
-	queue.push(start);
-	while (!queue.empty()) {
-		auto tmp = queue.front();
-		queue.pop();
-		if (visited[tmp])
-			continue;
-		visited[tmp] = true;
-		for (std::size_t i = 0; i < m_data[tmp].second.size(); ++i) {
-			if (edgeExist(tmp, i)) {
-				queue.push(i);
-			}
+	struct Printer : GraphVisitor {
+		bool discover_vertex(std::size_t node, const Graph& graph)
+		{
+			std::cout << graph.vertexData(node) << ", ";
+			return true;
 		}
-		std::cout << m_data[tmp].first << ", ";
-	}
+	};
+	bfsVisit(start, Printer{});
 	std::cout << std::endl;
 }
 
 template <typename V, typename E>
 void Graph<V, E>::dfs(std::size_t start) const
 {
-	std::vector<bool> visited(m_data.size());
-	std::stack<std::size_t> stack{};
-	stack.push(start);
+	for (auto it = beginDFS(start); it != endDFS(); ++it)
+		std::cout << *it << ", ";
+	std::cout << std::endl;
+}
+
+template <typename V, typename E>
+template <typename Visitor>
+bool Graph<V, E>::bfsVisit(std::size_t start, Visitor&& visitor) const
+{
+	const auto number_of_vertices = nrOfVertices();
+	// vertices are marked when discovered, so the queue never exceeds V
+	std::vector<bool> visited(number_of_vertices);
+	std::vector<std::size_t> queue{};
+	queue.reserve(number_of_vertices);
+
+	visited[start] = true;
+	if (!visitor.discover_vertex(start, *this))
+		return false;
+	queue.push_back(start);
+	for (std::size_t head = 0; head < queue.size(); ++head) {
+		const auto current = queue[head];
+		const auto& row = m_data[current].second;
+		for (std::size_t i = 0; i < number_of_vertices; ++i) {
+			if (!row[i].has_value())
+				continue;
+			if (!visitor.examine_edge(current, i, *this))
+				return false;
+			if (visited[i])
+				continue;
+			visited[i] = true;
+			if (!visitor.discover_vertex(i, *this))
+				return false;
+			queue.push_back(i);
+		}
+		if (!visitor.finish_vertex(current, *this))
+			return false;
+	}
+	return true;
+}
+
+template <typename V, typename E>
+template <typename Visitor>
+bool Graph<V, E>::dfsVisit(std::size_t start, Visitor&& visitor) const
+{
+	const auto number_of_vertices = nrOfVertices();
+	std::vector<bool> visited(number_of_vertices);
+	// (vertex, next neighbour to scan)
+	std::vector<std::pair<std::size_t, std::size_t>> stack{};
+
+	visited[start] = true;
+	if (!visitor.discover_vertex(start, *this))
+		return false;
+	stack.emplace_back(start, 0);
 	while (!stack.empty()) {
-		auto tmp = stack.top();
-		stack.pop();
-		if (visited[tmp])
+		auto& [current, next] = stack.back();
+		const auto& row = m_data[current].second;
+		while (next < number_of_vertices && !row[next].has_value())
+			++next;
+		if (next == number_of_vertices) {
+			if (!visitor.finish_vertex(current, *this))
+				return false;
+			stack.pop_back();
+			continue;
+		}
+		const auto i = next++;
+		if (!visitor.examine_edge(current, i, *this))
+			return false;
+		if (visited[i])
 			continue;
-		visited[tmp] = true;
-		for (std::size_t i = m_data[tmp].second.size(); i > 0; --i) {
-			if (edgeExist(tmp, i - 1)) {
-				stack.push(i - 1);
+		visited[i] = true;
+		if (!visitor.discover_vertex(i, *this))
+			return false;
+		// invalidates current and next
+		stack.emplace_back(i, 0);
+	}
+	return true;
+}
+
+template <typename V, typename E>
+typename Graph<V, E>::Neighborhoods Graph<V, E>::kHopNeighborhoods(
+	const std::vector<std::size_t>& seeds,
+	std::size_t hops,
+	std::size_t threads) const
+{
+	const auto blocks
+		= (seeds.size() + NEIGHBORHOOD_BLOCK - 1) / NEIGHBORHOOD_BLOCK;
+	// no more workers than blocks, but at least one
+	const auto workers = std::min(ThreadPool::threadCount(threads), blocks);
+	ThreadPool pool{std::max<std::size_t>(workers, 1)};
+	return kHopNeighborhoods(seeds, hops, pool);
+}
+
+template <typename V, typename E>
+typename Graph<V, E>::Neighborhoods Graph<V, E>::kHopNeighborhoods(
+	const std::vector<std::size_t>& seeds,
+	std::size_t hops,
+	ThreadPool& pool) const
+{
+	// seeds are processed in blocks, each block gets its own output
+	constexpr std::size_t block_size = NEIGHBORHOOD_BLOCK;
+	const auto number_of_vertices = nrOfVertices();
+	const auto blocks = (seeds.size() + block_size - 1) / block_size;
+	Neighborhoods result{};
+	result.offsets.push_back(0);
+	if (blocks == 0)
+		return result;
+
+	// offsets of a block are relative to its own vertices
+	std::vector<Neighborhoods> partial(blocks);
+	// visit marks shared by all seeds of a worker, a vertex is visited from
+	// seed s if its mark is s + 1, so they never have to be cleared
+	std::vector<std::vector<std::size_t>> marks(pool.size());
+
+	pool.parallelFor(blocks, [&](std::size_t worker, std::size_t block) {
+		auto& mark = marks[worker];
+		if (mark.empty())
+			mark.assign(number_of_vertices, 0);
+		auto& out = partial[block];
+		const auto first = block * block_size;
+		const auto last = std::min(first + block_size, seeds.size());
+		for (auto s = first; s < last; ++s) {
+			// out.vertices is the BFS queue, processed one level at a time
+			mark[seeds[s]] = s + 1;
+			auto level_begin = out.vertices.size();
+			out.vertices.push_back(seeds[s]);
+			auto level_end = out.vertices.size();
+			for (std::size_t depth = 0;
+				 depth < hops && level_begin != level_end;
+				 ++depth) {
+				for (auto q = level_begin; q < level_end; ++q) {
+					const auto& row = m_data[out.vertices[q]].second;
+					for (std::size_t i = 0; i < number_of_vertices; ++i) {
+						if (!row[i].has_value() || mark[i] == s + 1)
+							continue;
+						mark[i] = s + 1;
+						out.vertices.push_back(i);
+					}
+				}
+				level_begin = level_end;
+				level_end = out.vertices.size();
 			}
+			out.offsets.push_back(out.vertices.size());
 		}
-		std::cout << m_data[tmp].first << ", ";
+	});
+
+	std::size_t total{0};
+	for (const auto& part : partial)
+		total += part.vertices.size();
+	result.offsets.reserve(seeds.size() + 1);
+	result.vertices.reserve(total);
+	for (const auto& part : partial) {
+		const auto base = result.vertices.size();
+		result.vertices.insert(
+			result.vertices.end(), part.vertices.begin(), part.vertices.end());
+		for (auto end : part.offsets)
+			result.offsets.push_back(base + end);
 	}
-	std::cout << std::endl;
+	return result;
 }
 
 template <typename V, typename E>
@@ -367,60 +844,777 @@ std::pair<double, std::vector<std::size_t>> Graph<V, E>::dijkstra(
 	const std::size_t end,
 	const std::function<double(const E&)> f) const
 {
-	const auto comp
-		= [](const auto& lhs, const auto& rhs) { return lhs.cost > rhs.cost; };
-	struct node_elem {
-		std::size_t node{0};
-		double cost{0};
-		std::size_t previous{0};
-	};
+	SearchWorkspace<double> workspace{};
+	return dijkstra(start, end, f, workspace);
+}
+
+template <typename V, typename E>
+template <typename F>
+std::pair<double, std::vector<std::size_t>>
+Graph<V, E>::dijkstra(const std::size_t start, const std::size_t end, F f) const
+{
+	SearchWorkspaceFor<EdgeLength<F, E>> workspace{};
+	return dijkstra(start, end, f, workspace);
+}
+
+template <typename V, typename E>
+template <typename F, typename Cost, typename Heap>
+std::pair<double, std::vector<std::size_t>> Graph<V, E>::dijkstra(
+	const std::size_t start,
+	const std::size_t end,
+	F f,
+	SearchWorkspace<Cost, Heap>& workspace) const
+{
+	using Length = EdgeLength<F, E>;
+
 	const auto number_of_vertices = nrOfVertices();
 
-	std::priority_queue<node_elem, std::vector<node_elem>, decltype(comp)>
-		frontier(comp);
-	frontier.push({start, 0, end}); // end is a magic number here
-	std::unordered_map<std::size_t, std::size_t> previous;
+	workspace.reset(number_of_vertices);
+	auto& frontier = workspace.heap();
+	workspace.reach(start, 0, start);
+	frontier.push(start, 0);
 
 	while (!frontier.empty()) {
-		auto current = frontier.top();
+		const auto current = frontier.top();
 		frontier.pop();
-		// std::cout << " *** visiting " << current.node << " from " <<
-		// current.previous << std::endl;
-
-		if (current.node == end) {
-			// retrun solution
-			std::vector<std::size_t> out{end};
-			auto tmp = current.previous;
-			do {
-				out.push_back(tmp);
-				tmp = previous[tmp];
-			} while (tmp != end); // end is a magic number here
-			std::reverse(out.begin(), out.end());
-			return std::make_pair(current.cost, out);
-		}
-		if (previous.count(current.node))
+		// outdated entry
+		if (workspace.settled(current))
 			continue;
+		const auto current_cost = workspace.distance(current);
+
+		if (current == end)
+			return std::make_pair(
+				static_cast<double>(current_cost), workspace.path(end));
 
 		// mark as visited
-		previous[current.node] = current.previous;
+		workspace.settle(current);
+		const auto& row = m_data[current].second;
 		// loop through all neighbors
 		for (std::size_t i = 0; i < number_of_vertices; ++i) {
 			// if edge does not exist
-			if (!edgeExist(current.node, i))
+			if (!row[i].has_value())
 				continue;
 			// if visited
-			if (previous.count(i))
+			if (workspace.settled(i))
 				continue;
 
-			const auto& edge = m_data[current.node].second[i];
-			const double cost = f(*edge);
-			node_elem new_value{i, current.cost + cost, current.node};
-			frontier.push(new_value);
+			const Length length = f(*row[i]);
+			if constexpr (std::is_signed_v<Length>)
+				if (length < 0)
+					throw std::domain_error{"Ujemna długość krawędzi"};
+			const Cost cost = current_cost + static_cast<Cost>(length);
+			if (!workspace.reached(i)) {
+				workspace.reach(i, cost, current);
+				frontier.push(i, cost);
+			} else if (cost < workspace.distance(i)) {
+				workspace.reach(i, cost, current);
+				frontier.decrease(i, cost);
+			}
 		}
 	}
 	throw std::runtime_error{"No valid path"};
 }
 
+template <typename V, typename E>
+template <typename F>
+std::pair<double, std::vector<std::size_t>> Graph<V, E>::bidirectionalDijkstra(
+	const std::size_t start,
+	const std::size_t end,
+	F f) const
+{
+	SearchWorkspace<double> forward{};
+	SearchWorkspace<double> backward{};
+	return bidirectionalDijkstra(start, end, f, forward, backward);
+}
+
+template <typename V, typename E>
+template <typename F, typename Heap>
+std::pair<double, std::vector<std::size_t>> Graph<V, E>::bidirectionalDijkstra(
+	const std::size_t start,
+	const std::size_t end,
+	F f,
+	SearchWorkspace<double, Heap>& forward,
+	SearchWorkspace<double, Heap>& backward) const
+{
+	const auto zero = [](std::size_t) { return 0.; };
+	return bidirectionalSearch(start, end, f, zero, forward, backward);
+}
+
+template <typename V, typename E>
+template <typename F, typename H>
+std::pair<double, std::vector<std::size_t>> Graph<V, E>::bidirectionalAStar(
+	const std::size_t start,
+	const std::size_t end,
+	F f,
+	H h) const
+{
+	// averaged potential, the backward search uses its negation, so both
+	// searches see the same non-negative reduced edge lengths
+	std::vector<double> potentials(
+		nrOfVertices(), std::numeric_limits<double>::quiet_NaN());
+	const auto potential = [&](std::size_t node) {
+		auto& value = potentials[node];
+		if (std::isnan(value))
+			value = (h(*this, node, end) - h(*this, start, node)) / 2;
+		return value;
+	};
+	SearchWorkspace<double> forward{};
+	SearchWorkspace<double> backward{};
+	return bidirectionalSearch(start, end, f, potential, forward, backward);
+}
+
+// bidirectional Dijkstra on lengths reduced by the potential, heap keys are
+// distance + potential forwards and distance - potential backwards, so the
+// stopping rule stays "sum of frontier keys >= best path"
+template <typename V, typename E>
+template <typename F, typename P, typename Heap>
+std::pair<double, std::vector<std::size_t>> Graph<V, E>::bidirectionalSearch(
+	const std::size_t start,
+	const std::size_t end,
+	F f,
+	P potential,
+	SearchWorkspace<double, Heap>& forward,
+	SearchWorkspace<double, Heap>& backward) const
+{
+	const auto number_of_vertices = nrOfVertices();
+	if (start == end)
+		return std::make_pair(0., std::vector<std::size_t>{start});
+
+	forward.reset(number_of_vertices);
+	backward.reset(number_of_vertices);
+	forward.reach(start, 0, start);
+	forward.heap().push(start, potential(start));
+	backward.reach(end, 0, end);
+	backward.heap().push(end, -potential(end));
+
+	// length of the best path found so far and the vertex where it meets
+	double best = std::numeric_limits<double>::infinity();
+	std::size_t meeting = number_of_vertices;
+
+	// the stopping rule is only valid for non-negative lengths
+	const auto length = [&f](const E& edge) {
+		const auto out = f(edge);
+		if constexpr (std::is_signed_v<EdgeLength<F, E>>)
+			if (out < 0)
+				throw std::domain_error{"Ujemna długość krawędzi"};
+		return static_cast<double>(out);
+	};
+
+	const auto relax = [&](auto& search,
+						   const auto& other,
+						   double sign,
+						   std::size_t from,
+						   std::size_t to,
+						   double cost) {
+		if (search.settled(to))
+			return;
+		if (!search.reached(to)) {
+			search.reach(to, cost, from);
+			search.heap().push(to, cost + sign * potential(to));
+		} else if (cost < search.distance(to)) {
+			search.reach(to, cost, from);
+			search.heap().decrease(to, cost + sign * potential(to));
+		} else {
+			return;
+		}
+		if (other.reached(to) && cost + other.distance(to) < best) {
+			best = cost + other.distance(to);
+			meeting = to;
+		}
+	};
+
+	while (!forward.heap().empty() && !backward.heap().empty()) {
+		// no shorter path can be completed from the two frontiers
+		if (forward.heap().topKey() + backward.heap().topKey() >= best)
+			break;
+
+		const bool go_forward
+			= forward.heap().topKey() <= backward.heap().topKey();
+		auto& search = go_forward ? forward : backward;
+		const auto current = search.heap().top();
+		search.heap().pop();
+		// outdated entry
+		if (search.settled(current))
+			continue;
+		search.settle(current);
+		const auto current_cost = search.distance(current);
+
+		if (go_forward) {
+			const auto& row = m_data[current].second;
+			for (std::size_t i = 0; i < number_of_vertices; ++i)
+				if (row[i].has_value())
+					relax(
+						forward,
+						backward,
+						1.,
+						current,
+						i,
+						current_cost + length(*row[i]));
+		} else {
+			for (std::size_t i = 0; i < number_of_vertices; ++i) {
+				const auto& edge = m_data[i].second[current];
+				if (edge.has_value())
+					relax(
+						backward,
+						forward,
+						-1.,
+						current,
+						i,
+						current_cost + length(*edge));
+			}
+		}
+	}
+	if (meeting == number_of_vertices)
+		throw std::runtime_error{"No valid path"};
+
+	// the backward predecessors lead towards the end
+	auto out = forward.path(meeting);
+	for (auto node = meeting; node != end; node = backward.previous(node))
+		out.push_back(backward.previous(node));
+	return std::make_pair(best, out);
+}
+
+template <typename V, typename E>
+template <typename F>
+typename Graph<V, E>::ShortestPathTree Graph<V, E>::shortestPathTree(
+	const std::size_t source,
+	F f,
+	const double radius) const
+{
+	const auto number_of_vertices = nrOfVertices();
+	ShortestPathTree out{};
+	out.distance.assign(
+		number_of_vertices, std::numeric_limits<double>::infinity());
+	out.parent.assign(number_of_vertices, number_of_vertices);
+
+	SearchWorkspaceFor<EdgeLength<F, E>> workspace{};
+	settleFrom(source, f, workspace, [&](std::size_t node, double cost) {
+		if (cost > radius)
+			return false;
+		out.distance[node] = cost;
+		out.parent[node] = workspace.previous(node);
+		return true;
+	});
+	return out;
+}
+
+template <typename V, typename E>
+template <typename F>
+typename Graph<V, E>::ShortestPathTree Graph<V, E>::shortestPathTree(
+	const std::size_t source,
+	F f,
+	const std::vector<std::size_t>& targets) const
+{
+	const auto number_of_vertices = nrOfVertices();
+	ShortestPathTree out{};
+	out.distance.assign(
+		number_of_vertices, std::numeric_limits<double>::infinity());
+	out.parent.assign(number_of_vertices, number_of_vertices);
+
+	// targets not yet in the tree
+	std::vector<char> wanted(number_of_vertices, 0);
+	std::size_t remaining = 0;
+	for (const auto target : targets)
+		if (!wanted[target]) {
+			wanted[target] = 1;
+			++remaining;
+		}
+
+	SearchWorkspaceFor<EdgeLength<F, E>> workspace{};
+	settleFrom(source, f, workspace, [&](std::size_t node, double cost) {
+		out.distance[node] = cost;
+		out.parent[node] = workspace.previous(node);
+		if (wanted[node])
+			--remaining;
+		return remaining != 0;
+	});
+	return out;
+}
+
+template <typename V, typename E>
+template <typename F>
+std::vector<double> Graph<V, E>::distanceTable(
+	const std::vector<std::size_t>& sources,
+	const std::vector<std::size_t>& targets,
+	F f,
+	std::size_t threads) const
+{
+	// no more workers than sources, but at least one
+	const auto workers
+		= std::min(ThreadPool::threadCount(threads), sources.size());
+	ThreadPool pool{std::max<std::size_t>(workers, 1)};
+	return distanceTable(sources, targets, f, pool);
+}
+
+template <typename V, typename E>
+template <typename F>
+std::vector<double> Graph<V, E>::distanceTable(
+	const std::vector<std::size_t>& sources,
+	const std::vector<std::size_t>& targets,
+	F f,
+	ThreadPool& pool) const
+{
+	const auto number_of_vertices = nrOfVertices();
+	const auto columns = targets.size();
+	std::vector<double> out(
+		sources.size() * columns, std::numeric_limits<double>::infinity());
+	if (out.empty())
+		return out;
+
+	// columns of every vertex, a vertex may be asked for more than once
+	std::vector<std::size_t> column_offsets(number_of_vertices + 1, 0);
+	for (const auto target : targets)
+		++column_offsets[target + 1];
+	std::size_t distinct{0};
+	for (std::size_t i = 0; i < number_of_vertices; ++i) {
+		distinct += column_offsets[i + 1] != 0;
+		column_offsets[i + 1] += column_offsets[i];
+	}
+	std::vector<std::size_t> target_columns(columns);
+	{
+		auto next = column_offsets;
+		for (std::size_t j = 0; j < columns; ++j)
+			target_columns[next[targets[j]]++] = j;
+	}
+
+	std::vector<SearchWorkspaceFor<EdgeLength<F, E>>>
+		workspaces(pool.size());
+
+	pool.parallelFor(sources.size(), [&](std::size_t worker, std::size_t i) {
+		auto* row = &out[i * columns];
+		auto remaining = distinct;
+		settleFrom(
+			sources[i],
+			f,
+			workspaces[worker],
+			[&](std::size_t node, double cost) {
+				const auto first = column_offsets[node];
+				const auto last = column_offsets[node + 1];
+				if (first == last)
+					return true;
+				for (auto j = first; j < last; ++j)
+					row[target_columns[j]] = cost;
+				return --remaining != 0;
+			});
+	});
+	return out;
+}
+
+template <typename V, typename E>
+template <typename F>
+std::vector<double> Graph<V, E>::deltaStepping(
+	const std::size_t source,
+	F f,
+	const double delta,
+	std::size_t threads) const
+{
+	ThreadPool pool{ThreadPool::threadCount(threads)};
+	return deltaStepping(source, f, delta, pool);
+}
+
+template <typename V, typename E>
+template <typename F>
+std::vector<double> Graph<V, E>::deltaStepping(
+	const std::size_t source,
+	F f,
+	const double delta,
+	ThreadPool& pool) const
+{
+	using Length = EdgeLength<F, E>;
+
+	if (!(delta > 0))
+		throw std::domain_error{"Szerokość kubełka musi być dodatnia"};
+	const auto number_of_vertices = nrOfVertices();
+	const auto infinity = std::numeric_limits<double>::infinity();
+	std::vector<std::atomic<double>> distance(number_of_vertices);
+	for (auto& value : distance)
+		value.store(infinity, std::memory_order_relaxed);
+
+	// vertices whose distance was lowered, per worker
+	std::vector<std::vector<std::size_t>> improved(pool.size());
+
+	// buckets may hold outdated entries, bucket_of tells where a vertex
+	// really is (none - not in any bucket)
+	const auto none = std::numeric_limits<std::size_t>::max();
+	std::map<std::size_t, std::vector<std::size_t>> buckets{};
+	std::vector<std::size_t> bucket_of(number_of_vertices, none);
+	const auto insert = [&](std::size_t node) {
+		const auto index = static_cast<std::size_t>(
+			distance[node].load(std::memory_order_relaxed) / delta);
+		if (bucket_of[node] == index)
+			return;
+		bucket_of[node] = index;
+		buckets[index].push_back(node);
+	};
+	const auto collect = [&]() {
+		for (auto& list : improved) {
+			for (const auto node : list)
+				insert(node);
+			list.clear();
+		}
+	};
+
+	// relaxes the light (or heavy) edges of all the given vertices
+	const auto relax = [&](const std::vector<std::size_t>& nodes, bool light) {
+		pool.parallelFor(nodes.size(), [&](std::size_t worker, std::size_t i) {
+			const auto current = nodes[i];
+			const auto current_cost
+				= distance[current].load(std::memory_order_relaxed);
+			const auto& row = m_data[current].second;
+			for (std::size_t j = 0; j < number_of_vertices; ++j) {
+				if (!row[j].has_value())
+					continue;
+				const Length length = f(*row[j]);
+				// a negative length would give a negative bucket index
+				if constexpr (std::is_signed_v<Length>)
+					if (length < 0)
+						throw std::domain_error{"Ujemna długość krawędzi"};
+				const auto weight = static_cast<double>(length);
+				if ((weight <= delta) != light)
+					continue;
+				// atomic minimum
+				const auto cost = current_cost + weight;
+				auto& target = distance[j];
+				auto old = target.load(std::memory_order_relaxed);
+				while (cost < old
+					   && !target.compare_exchange_weak(
+						   old, cost, std::memory_order_relaxed))
+					;
+				if (cost < old)
+					improved[worker].push_back(j);
+			}
+		});
+	};
+
+	distance[source].store(0, std::memory_order_relaxed);
+	insert(source);
+	std::vector<std::size_t> frontier{};
+	std::vector<std::size_t> settled{};
+	while (!buckets.empty()) {
+		const auto index = buckets.begin()->first;
+		settled.clear();
+		// light edges can put vertices back into the same bucket
+		while (buckets.count(index)) {
+			frontier.clear();
+			for (const auto node : buckets[index])
+				if (bucket_of[node] == index) {
+					bucket_of[node] = none;
+					frontier.push_back(node);
+				}
+			buckets.erase(index);
+			relax(frontier, true);
+			collect();
+			settled.insert(settled.end(), frontier.begin(), frontier.end());
+		}
+		relax(settled, false);
+		collect();
+	}
+
+	std::vector<double> out(number_of_vertices);
+	for (std::size_t i = 0; i < number_of_vertices; ++i)
+		out[i] = distance[i].load(std::memory_order_relaxed);
+	return out;
+}
+
+template <typename V, typename E>
+template <typename F>
+typename Graph<V, E>::ShortestPathTree Graph<V, E>::bellmanFord(
+	const std::size_t source,
+	F f,
+	std::size_t threads) const
+{
+	return bellmanFord(std::vector<std::size_t>{source}, f, threads);
+}
+
+template <typename V, typename E>
+template <typename F>
+typename Graph<V, E>::ShortestPathTree Graph<V, E>::bellmanFord(
+	const std::size_t source,
+	F f,
+	ThreadPool& pool) const
+{
+	return bellmanFord(std::vector<std::size_t>{source}, f, pool);
+}
+
+template <typename V, typename E>
+template <typename F>
+typename Graph<V, E>::ShortestPathTree Graph<V, E>::bellmanFord(
+	const std::vector<std::size_t>& sources,
+	F f,
+	std::size_t threads) const
+{
+	ThreadPool pool{ThreadPool::threadCount(threads)};
+	return bellmanFord(sources, f, pool);
+}
+
+template <typename V, typename E>
+template <typename F>
+typename Graph<V, E>::ShortestPathTree Graph<V, E>::bellmanFord(
+	const std::vector<std::size_t>& sources,
+	F f,
+	ThreadPool& pool) const
+{
+	const auto number_of_vertices = nrOfVertices();
+	ShortestPathTree out{};
+	out.distance.assign(
+		number_of_vertices, std::numeric_limits<double>::infinity());
+	out.parent.assign(number_of_vertices, number_of_vertices);
+
+	// vertices improved by the last round, each at most once
+	std::vector<std::size_t> frontier{};
+	std::vector<char> in_frontier(number_of_vertices, 0);
+	for (const auto source : sources) {
+		out.distance[source] = 0;
+		out.parent[source] = source;
+		if (!in_frontier[source]) {
+			in_frontier[source] = 1;
+			frontier.push_back(source);
+		}
+	}
+
+	// (vertex, distance, parent) found by every worker, distances of a
+	// round are read only, so improvements are merged after it
+	std::vector<std::vector<std::tuple<std::size_t, double, std::size_t>>>
+		improved(pool.size());
+
+	// after round i all shortest paths with at most i edges are known, so
+	// an improvement in round number_of_vertices needs a negative cycle
+	for (std::size_t round = 0; !frontier.empty(); ++round) {
+		if (round == number_of_vertices)
+			throw std::domain_error{"Graf zawiera ujemny cykl"};
+		pool.parallelFor(
+			frontier.size(), [&](std::size_t worker, std::size_t i) {
+				const auto current = frontier[i];
+				const auto current_cost = out.distance[current];
+				const auto& row = m_data[current].second;
+				for (std::size_t j = 0; j < number_of_vertices; ++j) {
+					if (!row[j].has_value())
+						continue;
+					const auto cost
+						= current_cost + static_cast<double>(f(*row[j]));
+					if (cost < out.distance[j])
+						improved[worker].emplace_back(j, cost, current);
+				}
+			});
+		for (const auto node : frontier)
+			in_frontier[node] = 0;
+		frontier.clear();
+		for (auto& list : improved) {
+			for (const auto& [node, cost, parent] : list)
+				if (cost < out.distance[node]) {
+					out.distance[node] = cost;
+					out.parent[node] = parent;
+					if (!in_frontier[node]) {
+						in_frontier[node] = 1;
+						frontier.push_back(node);
+					}
+				}
+			list.clear();
+		}
+	}
+	return out;
+}
+
+template <typename V, typename E>
+template <typename F>
+std::vector<std::pair<double, std::vector<std::size_t>>>
+Graph<V, E>::kShortestPaths(
+	const std::size_t start,
+	const std::size_t end,
+	const std::size_t k,
+	F f) const
+{
+	using Length = EdgeLength<F, E>;
+	using Path = std::pair<double, std::vector<std::size_t>>;
+	constexpr auto INF = std::numeric_limits<double>::infinity();
+
+	const auto number_of_vertices = nrOfVertices();
+	const auto length = [&](std::size_t from, std::size_t to) {
+		return static_cast<double>(f(*m_data[from].second[to]));
+	};
+
+	// backward search from the end, following in-edges: the distance to the
+	// end and the next vertex on the way, masking only makes paths longer, so
+	// the distances stay a consistent heuristic of every spur search
+	SearchWorkspace<double> workspace{};
+	std::vector<double> to_end(number_of_vertices, INF);
+	std::vector<std::size_t> next(number_of_vertices, number_of_vertices);
+	workspace.reset(number_of_vertices);
+	workspace.reach(end, 0, end);
+	workspace.heap().push(end, 0);
+	while (!workspace.heap().empty()) {
+		const auto current = workspace.heap().top();
+		workspace.heap().pop();
+		if (workspace.settled(current))
+			continue;
+		workspace.settle(current);
+		to_end[current] = workspace.distance(current);
+		next[current] = workspace.previous(current);
+		for (std::size_t i = 0; i < number_of_vertices; ++i) {
+			if (!m_data[i].second[current].has_value() || workspace.settled(i))
+				continue;
+			const Length edge = f(*m_data[i].second[current]);
+			if constexpr (std::is_signed_v<Length>)
+				if (edge < 0)
+					throw std::domain_error{"Ujemna długość krawędzi"};
+			const auto cost = to_end[current] + static_cast<double>(edge);
+			if (!workspace.reached(i)) {
+				workspace.reach(i, cost, current);
+				workspace.heap().push(i, cost);
+			} else if (cost < workspace.distance(i)) {
+				workspace.reach(i, cost, current);
+				workspace.heap().decrease(i, cost);
+			}
+		}
+	}
+
+	std::vector<Path> out{};
+	if (k == 0 || to_end[start] == INF)
+		return out;
+	const auto tree_path = [&](std::size_t from) {
+		std::vector<std::size_t> path{from};
+		while (path.back() != end)
+			path.push_back(next[path.back()]);
+		return path;
+	};
+	out.emplace_back(to_end[start], tree_path(start));
+
+	// candidates ordered by length, every path is found once
+	std::set<Path> candidates{};
+	std::set<std::vector<std::size_t>> known{out.front().second};
+	// the mask: vertices of the root path and edges leaving the spur vertex
+	std::vector<char> banned(number_of_vertices, 0);
+	std::vector<char> banned_next(number_of_vertices, 0);
+
+	// the shortest path from the spur vertex avoiding the mask
+	const auto spur_path = [&](std::size_t spur) -> Path {
+		// the tree path is the best one unless the mask cuts it
+		auto free = !banned_next[next[spur]];
+		for (auto node = next[spur]; free && node != end; node = next[node])
+			free = !banned[node];
+		if (free)
+			return Path{to_end[spur], tree_path(spur)};
+
+		workspace.reset(number_of_vertices);
+		auto& frontier = workspace.heap();
+		workspace.reach(spur, 0, spur);
+		frontier.push(spur, to_end[spur]);
+		while (!frontier.empty()) {
+			const auto current = frontier.top();
+			frontier.pop();
+			if (workspace.settled(current))
+				continue;
+			const auto current_cost = workspace.distance(current);
+			if (current == end)
+				return Path{current_cost, workspace.path(end)};
+			workspace.settle(current);
+			const auto& row = m_data[current].second;
+			for (std::size_t i = 0; i < number_of_vertices; ++i) {
+				if (!row[i].has_value() || banned[i] || to_end[i] == INF
+					|| (current == spur && banned_next[i])
+					|| workspace.settled(i))
+					continue;
+				const auto cost = current_cost + length(current, i);
+				if (!workspace.reached(i)) {
+					workspace.reach(i, cost, current);
+					frontier.push(i, cost + to_end[i]);
+				} else if (cost < workspace.distance(i)) {
+					workspace.reach(i, cost, current);
+					frontier.decrease(i, cost + to_end[i]);
+				}
+			}
+		}
+		return Path{INF, {}};
+	};
+
+	while (out.size() < k) {
+		const auto previous = out.back().second;
+		double root_cost = 0;
+		for (std::size_t i = 0; i + 1 < previous.size(); ++i) {
+			const auto spur = previous[i];
+			// paths already taken with the same root leave it by other edges
+			for (const auto& path : out)
+				if (path.second.size() > i + 1
+					&& std::equal(
+						previous.begin(),
+						previous.begin() + i + 1,
+						path.second.begin()))
+					banned_next[path.second[i + 1]] = 1;
+
+			const auto [spur_cost, spur_vertices] = spur_path(spur);
+			if (spur_cost != INF) {
+				std::vector<std::size_t> path(
+					previous.begin(), previous.begin() + i);
+				path.insert(
+					path.end(), spur_vertices.begin(), spur_vertices.end());
+				if (known.insert(path).second)
+					candidates.emplace(root_cost + spur_cost, std::move(path));
+			}
+
+			std::fill(banned_next.begin(), banned_next.end(), 0);
+			banned[spur] = 1;
+			root_cost += length(spur, previous[i + 1]);
+		}
+		for (const auto node : previous)
+			banned[node] = 0;
+
+		if (candidates.empty())
+			break;
+		out.push_back(*candidates.begin());
+		candidates.erase(candidates.begin());
+	}
+	return out;
+}
+
+template <typename V, typename E>
+template <typename F, typename Workspace, typename Visit>
+void Graph<V, E>::settleFrom(
+	const std::size_t source,
+	F f,
+	Workspace& workspace,
+	Visit visit) const
+{
+	using Length = EdgeLength<F, E>;
+	using Cost = decltype(workspace.distance(source));
+
+	const auto number_of_vertices = nrOfVertices();
+	workspace.reset(number_of_vertices);
+	auto& frontier = workspace.heap();
+	workspace.reach(source, 0, source);
+	frontier.push(source, 0);
+
+	while (!frontier.empty()) {
+		const auto current = frontier.top();
+		frontier.pop();
+		// outdated entry
+		if (workspace.settled(current))
+			continue;
+		const auto current_cost = workspace.distance(current);
+		workspace.settle(current);
+		if (!visit(current, static_cast<double>(current_cost)))
+			return;
+
+		const auto& row = m_data[current].second;
+		for (std::size_t i = 0; i < number_of_vertices; ++i) {
+			if (!row[i].has_value() || workspace.settled(i))
+				continue;
+
+			const Length length = f(*row[i]);
+			if constexpr (std::is_signed_v<Length>)
+				if (length < 0)
+					throw std::domain_error{"Ujemna długość krawędzi"};
+			const Cost cost = current_cost + static_cast<Cost>(length);
+			if (!workspace.reached(i)) {
+				workspace.reach(i, cost, current);
+				frontier.push(i, cost);
+			} else if (cost < workspace.distance(i)) {
+				workspace.reach(i, cost, current);
+				frontier.decrease(i, cost);
+			}
+		}
+	}
+}
+
 template <typename V, typename E>
 std::pair<double, std::vector<std::size_t>> Graph<V, E>::a_star(
 	const std::size_t start,
@@ -430,68 +1624,205 @@ std::pair<double, std::vector<std::size_t>> Graph<V, E>::a_star(
 		double(const Graph<V, E>&, const std::size_t, const std::size_t)> h)
 	const
 {
-	const auto comp = [](const auto& lhs, const auto& rhs) {
-		return lhs.expected_cost > rhs.expected_cost;
-	};
-	struct node_elem {
-		std::size_t node{0};
-		double cost{0};
-		double expected_cost{0};
-		std::size_t previous{0};
-	};
+	SearchWorkspace<double> workspace{};
+	return a_star(start, end, f, h, workspace);
+}
+
+template <typename V, typename E>
+template <typename Heap>
+std::pair<double, std::vector<std::size_t>> Graph<V, E>::a_star(
+	const std::size_t start,
+	const std::size_t end,
+	const std::function<double(const E&)> f,
+	const std::function<
+		double(const Graph<V, E>&, const std::size_t, const std::size_t)> h,
+	SearchWorkspace<double, Heap>& workspace) const
+{
 	const auto number_of_vertices = nrOfVertices();
 
-	std::priority_queue<node_elem, std::vector<node_elem>, decltype(comp)>
-		frontier(comp);
-	frontier.push({start, 0, 0, end}); // end is a magic number here
-	std::unordered_map<std::size_t, std::size_t> previous;
+	workspace.reset(number_of_vertices);
+	auto& frontier = workspace.heap();
+	workspace.reach(start, 0, start);
+	frontier.push(start, 0);
 
 	while (!frontier.empty()) {
-		auto current = frontier.top();
+		const auto current = frontier.top();
 		frontier.pop();
+		// outdated entry
+		if (workspace.settled(current))
+			continue;
+		const auto current_cost = workspace.distance(current);
 #if A_STAR_SHOW_VISITS
 		// debug print
-		std::cout << "    visiting " << current.node << " from "
-				  << current.previous << " with cost " << current.cost
-				  << std::endl;
+		std::cout << "    visiting " << current << " from "
+				  << workspace.previous(current) << " with cost "
+				  << current_cost << std::endl;
 #endif
 
-		if (current.node == end) {
-			// retrun solution
-			std::vector<std::size_t> out{end};
-			auto tmp = current.previous;
-			do {
-				out.push_back(tmp);
-				tmp = previous[tmp];
-			} while (tmp != end); // end is a magic number here
-			std::reverse(out.begin(), out.end());
-			return std::make_pair(current.cost, out);
-		}
-		if (previous.find(current.node) != previous.end())
-			continue;
+		if (current == end)
+			return std::make_pair(current_cost, workspace.path(end));
 
 		// mark as visited
-		previous[current.node] = current.previous;
+		workspace.settle(current);
+		const auto& row = m_data[current].second;
 		// loop through all neighbors
 		for (std::size_t i = 0; i < number_of_vertices; ++i) {
 			// if edge does not exist
-			if (!edgeExist(current.node, i))
+			if (!row[i].has_value())
 				continue;
 			// if visited
-			// if (previous.count(i))
-			if (previous.find(i) != previous.end())
+			if (workspace.settled(i))
 				continue;
 
-			const auto& edge = m_data[current.node].second[i];
-			const double cost = f(*edge);
-			node_elem new_value{i,
-								current.cost + cost,
-								current.cost + cost + h(*this, i, end),
-								current.node};
-			frontier.push(new_value);
+			const double cost = current_cost + f(*row[i]);
+			if (!workspace.reached(i)) {
+				workspace.reach(i, cost, current);
+				frontier.push(i, cost + h(*this, i, end));
+			} else if (cost < workspace.distance(i)) {
+				workspace.reach(i, cost, current);
+				frontier.decrease(i, cost + h(*this, i, end));
+			}
 		}
 	}
 	throw std::runtime_error{"No valid path"};
 }
 
+template <typename V, typename E>
+template <typename F, typename H>
+typename Graph<V, E>::BoundedPath Graph<V, E>::weightedAStar(
+	const std::size_t start,
+	const std::size_t end,
+	F f,
+	H h,
+	const double epsilon) const
+{
+	// no budget left for improvements after the first search
+	return anytimeAStar(
+		start, end, f, h, epsilon, std::chrono::steady_clock::time_point{}, 0);
+}
+
+template <typename V, typename E>
+template <typename F, typename H>
+typename Graph<V, E>::BoundedPath Graph<V, E>::anytimeAStar(
+	const std::size_t start,
+	const std::size_t end,
+	F f,
+	H h,
+	const double epsilon,
+	const std::chrono::steady_clock::time_point deadline,
+	const std::size_t expansions) const
+{
+	using Length = EdgeLength<F, E>;
+	constexpr auto INF = std::numeric_limits<double>::infinity();
+	// below that the next search is plain A*
+	constexpr double LAST_WEIGHT = 1.01;
+
+	if (!(epsilon >= 1))
+		throw std::domain_error{"Waga heurystyki musi wynosić co najmniej 1"};
+	const auto number_of_vertices = nrOfVertices();
+	std::vector<double> cost(number_of_vertices, INF);
+	std::vector<std::size_t> parent(number_of_vertices, number_of_vertices);
+	// the heuristic is called once per vertex, NaN - not yet
+	std::vector<double> estimate(
+		number_of_vertices, std::numeric_limits<double>::quiet_NaN());
+	const auto heuristic = [&](std::size_t node) {
+		if (std::isnan(estimate[node]))
+			estimate[node] = static_cast<double>(h(*this, node, end));
+		return estimate[node];
+	};
+	// expanded during the current search, improved after expansion
+	std::vector<char> closed(number_of_vertices, 0);
+	std::vector<std::size_t> inconsistent{};
+	IndexedHeap<double> open{};
+	open.clear(number_of_vertices);
+
+	double weight = epsilon;
+	cost[start] = 0;
+	parent[start] = start;
+	open.push(start, weight * heuristic(start));
+	BoundedPath best{INF, {}, INF};
+	std::size_t expanded = 0;
+	const auto budget_left = [&]() {
+		return expanded < expansions
+			&& std::chrono::steady_clock::now() < deadline;
+	};
+
+	while (true) {
+		// expand while some vertex could still improve the end
+		while (!open.empty()
+			   && open.topKey() < cost[end] + weight * heuristic(end)) {
+			if (best.length != INF && !budget_left())
+				return best;
+			const auto current = open.top();
+			open.pop();
+			closed[current] = 1;
+			++expanded;
+			const auto& row = m_data[current].second;
+			for (std::size_t i = 0; i < number_of_vertices; ++i) {
+				if (!row[i].has_value())
+					continue;
+				const Length length = f(*row[i]);
+				if constexpr (std::is_signed_v<Length>)
+					if (length < 0)
+						throw std::domain_error{"Ujemna długość krawędzi"};
+				const auto next = cost[current] + static_cast<double>(length);
+				if (!(next < cost[i]))
+					continue;
+				cost[i] = next;
+				parent[i] = current;
+				const auto key = next + weight * heuristic(i);
+				if (closed[i] == 1) {
+					// expanded again by the next search
+					closed[i] = 2;
+					inconsistent.push_back(i);
+				} else if (closed[i] == 0) {
+					if (open.contains(i))
+						open.decrease(i, key);
+					else
+						open.push(i, key);
+				}
+			}
+		}
+		if (cost[end] == INF)
+			throw std::runtime_error{"No valid path"};
+
+		// no vertex left in open or inconsistent can lead to a shorter path
+		// than cost + heuristic
+		std::vector<std::size_t> pending{};
+		while (!open.empty()) {
+			pending.push_back(open.top());
+			open.pop();
+		}
+		pending.insert(pending.end(), inconsistent.begin(), inconsistent.end());
+		double lower = INF;
+		for (const auto node : pending)
+			lower = std::min(lower, cost[node] + heuristic(node));
+
+		BoundedPath found{0, {end}, weight};
+		for (auto node = end; node != start; node = parent[node])
+			found.path.push_back(parent[node]);
+		std::reverse(found.path.begin(), found.path.end());
+		for (std::size_t i = 1; i < found.path.size(); ++i)
+			found.length += static_cast<double>(
+				f(*m_data[found.path[i - 1]].second[found.path[i]]));
+		if (lower >= found.length)
+			found.bound = 1;
+		else if (lower > 0)
+			found.bound = std::min(found.bound, found.length / lower);
+		// a path is never longer than the previous one
+		found.bound = std::min(found.bound, best.bound);
+		best = std::move(found);
+		if (best.bound == 1 || weight == 1 || !budget_left())
+			return best;
+
+		weight = 1 + (std::min(weight, best.bound) - 1) / 2;
+		if (weight < LAST_WEIGHT)
+			weight = 1;
+		std::fill(closed.begin(), closed.end(), 0);
+		inconsistent.clear();
+		for (const auto node : pending)
+			open.push(node, cost[node] + weight * heuristic(node));
+	}
+}
+
 #endif /* GRAPH_HPP */
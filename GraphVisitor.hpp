@@ -0,0 +1,30 @@
+#ifndef GRAPHVISITOR_HPP
+#define GRAPHVISITOR_HPP
+
+#include <cstddef>
+
+// base class for visitors passed to Graph::bfsVisit and Graph::dfsVisit
+// derived visitors hide the hooks they need, every hook returns false to stop
+// the traversal
+struct GraphVisitor {
+	// called once per reached vertex, before its edges are examined
+	template <typename G>
+	bool discover_vertex(std::size_t, const G&)
+	{
+		return true;
+	}
+	// called for every outgoing edge of a discovered vertex
+	template <typename G>
+	bool examine_edge(std::size_t, std::size_t, const G&)
+	{
+		return true;
+	}
+	// called after all edges of the vertex were examined
+	template <typename G>
+	bool finish_vertex(std::size_t, const G&)
+	{
+		return true;
+	}
+};
+
+#endif /* GRAPHVISITOR_HPP */
@@ -0,0 +1,419 @@
+#ifndef GRIDGRAPH_HPP
+#define GRIDGRAPH_HPP
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "SearchWorkspace.hpp"
+
+// 8-connected grid with straight moves of length 1 and diagonal moves of
+// length sqrt(2), the adjacency is implicit in a bitmap of blocked cells
+// a diagonal move only needs a free destination (corners may be cut, as in
+// the grid of the A* example), cells are numbered row by row
+// shortest paths come from Jump Point Search, straight jumps scan the bitmap
+// 64 cells at a time
+class GridGraph {
+public:
+	GridGraph() = default;
+	// all cells free
+	GridGraph(std::size_t, std::size_t);
+	GridGraph(const GridGraph&) = default;
+	GridGraph(GridGraph&&) = default;
+	GridGraph& operator=(const GridGraph&) = default;
+	GridGraph& operator=(GridGraph&&) = default;
+	~GridGraph() = default;
+
+	std::size_t width() const;
+	std::size_t height() const;
+	std::size_t nrOfVertices() const;
+	// id of the cell in the given column and row
+	std::size_t cell(std::size_t, std::size_t) const;
+	std::size_t column(std::size_t) const;
+	std::size_t row(std::size_t) const;
+
+	bool blocked(std::size_t) const;
+	void setBlocked(std::size_t, bool = true);
+
+	// same format as astar(): the length and every cell of the path, start
+	// and end included, throws runtime_error if there is no path
+	std::pair<double, std::vector<std::size_t>>
+	jumpPointSearch(std::size_t, std::size_t) const;
+	std::pair<double, std::vector<std::size_t>> jumpPointSearch(
+		std::size_t,
+		std::size_t,
+		SearchWorkspace<double>&) const;
+
+private:
+	// blocked cells of the grid with a blocked border around it, one copy per
+	// direction of straight jumps so that each of them scans a row forwards
+	struct Bitmap {
+		std::size_t stride{0};
+		std::vector<std::uint64_t> words{};
+
+		void assign(std::size_t, std::size_t);
+		bool test(std::size_t, std::size_t) const;
+		void set(std::size_t, std::size_t, bool);
+		// 64 cells of the row from the given column on, lowest bit first
+		std::uint64_t window(std::size_t, std::size_t) const;
+	};
+
+	enum Direction { EAST, WEST, SOUTH, NORTH };
+
+	static constexpr double SQRT_2 = 1.41421356237309504880;
+
+	static std::size_t lowestBit(std::uint64_t);
+	// octile distance, exact for a free grid
+	static double distance(std::ptrdiff_t, std::ptrdiff_t);
+
+	// coordinates with the border, from 0 to width + 1 and height + 1
+	bool blockedAt(std::ptrdiff_t, std::ptrdiff_t) const;
+	// steps to the first cell with a forced neighbour, or to the last free
+	// cell before a wall
+	std::pair<std::size_t, bool>
+	scan(Direction, std::ptrdiff_t, std::ptrdiff_t) const;
+	// steps to the jump point in the direction (0 - none)
+	std::size_t jump(
+		std::ptrdiff_t,
+		std::ptrdiff_t,
+		int,
+		int,
+		std::ptrdiff_t,
+		std::ptrdiff_t) const;
+
+	std::size_t m_width{0};
+	std::size_t m_height{0};
+	std::array<Bitmap, 4> m_bitmaps{};
+};
+
+////////////////////////////////////////
+// GridGraph implementation
+////////////////////////////////////////
+
+inline GridGraph::GridGraph(std::size_t width, std::size_t height)
+	: m_width{width}, m_height{height}
+{
+	m_bitmaps[EAST].assign(height + 2, width + 2);
+	m_bitmaps[WEST].assign(height + 2, width + 2);
+	m_bitmaps[SOUTH].assign(width + 2, height + 2);
+	m_bitmaps[NORTH].assign(width + 2, height + 2);
+	for (std::size_t i = 0; i < nrOfVertices(); ++i)
+		setBlocked(i, false);
+}
+
+inline std::size_t GridGraph::width() const
+{
+	return m_width;
+}
+
+inline std::size_t GridGraph::height() const
+{
+	return m_height;
+}
+
+inline std::size_t GridGraph::nrOfVertices() const
+{
+	return m_width * m_height;
+}
+
+inline std::size_t GridGraph::cell(std::size_t column, std::size_t row) const
+{
+	if (column >= m_width || row >= m_height)
+		throw std::out_of_range{"Index out of range"};
+	return row * m_width + column;
+}
+
+inline std::size_t GridGraph::column(std::size_t cell) const
+{
+	return cell % m_width;
+}
+
+inline std::size_t GridGraph::row(std::size_t cell) const
+{
+	return cell / m_width;
+}
+
+inline bool GridGraph::blocked(std::size_t cell) const
+{
+	if (cell >= nrOfVertices())
+		throw std::out_of_range{"Index out of range"};
+	return m_bitmaps[EAST].test(row(cell) + 1, column(cell) + 1);
+}
+
+inline void GridGraph::setBlocked(std::size_t cell, bool value)
+{
+	if (cell >= nrOfVertices())
+		throw std::out_of_range{"Index out of range"};
+	const auto x = column(cell) + 1;
+	const auto y = row(cell) + 1;
+	m_bitmaps[EAST].set(y, x, value);
+	m_bitmaps[WEST].set(y, m_width + 1 - x, value);
+	m_bitmaps[SOUTH].set(x, y, value);
+	m_bitmaps[NORTH].set(x, m_height + 1 - y, value);
+}
+
+inline std::pair<double, std::vector<std::size_t>>
+GridGraph::jumpPointSearch(std::size_t start, std::size_t end) const
+{
+	SearchWorkspace<double> workspace{};
+	return jumpPointSearch(start, end, workspace);
+}
+
+inline std::pair<double, std::vector<std::size_t>> GridGraph::jumpPointSearch(
+	std::size_t start,
+	std::size_t end,
+	SearchWorkspace<double>& workspace) const
+{
+	if (blocked(start) || blocked(end))
+		throw std::runtime_error{"No valid path"};
+	const auto x_of = [this](std::size_t cell) {
+		return static_cast<std::ptrdiff_t>(column(cell)) + 1;
+	};
+	const auto y_of = [this](std::size_t cell) {
+		return static_cast<std::ptrdiff_t>(row(cell)) + 1;
+	};
+	const auto end_x = x_of(end);
+	const auto end_y = y_of(end);
+	const auto heuristic = [&](std::ptrdiff_t x, std::ptrdiff_t y) {
+		return distance(end_x - x, end_y - y);
+	};
+	const auto sign = [](std::ptrdiff_t value) {
+		return static_cast<int>((value > 0) - (value < 0));
+	};
+
+	workspace.reset(nrOfVertices());
+	auto& frontier = workspace.heap();
+	workspace.reach(start, 0, start);
+	frontier.push(start, heuristic(x_of(start), y_of(start)));
+
+	while (!frontier.empty()) {
+		const auto current = frontier.top();
+		frontier.pop();
+		// outdated entry
+		if (workspace.settled(current))
+			continue;
+		const auto current_cost = workspace.distance(current);
+		if (current == end)
+			break;
+		workspace.settle(current);
+
+		const auto x = x_of(current);
+		const auto y = y_of(current);
+		// directions not covered by a symmetric path through the parent
+		std::array<std::pair<int, int>, 8> directions{};
+		std::size_t count = 0;
+		const auto parent = workspace.previous(current);
+		if (parent == current) {
+			for (int dx = -1; dx <= 1; ++dx)
+				for (int dy = -1; dy <= 1; ++dy)
+					if (dx != 0 || dy != 0)
+						directions[count++] = {dx, dy};
+		} else {
+			const auto dx = sign(x - x_of(parent));
+			const auto dy = sign(y - y_of(parent));
+			if (dx != 0 && dy != 0) {
+				directions[count++] = {dx, dy};
+				directions[count++] = {dx, 0};
+				directions[count++] = {0, dy};
+				if (blockedAt(x - dx, y))
+					directions[count++] = {-dx, dy};
+				if (blockedAt(x, y - dy))
+					directions[count++] = {dx, -dy};
+			} else if (dy == 0) {
+				directions[count++] = {dx, 0};
+				if (blockedAt(x, y + 1))
+					directions[count++] = {dx, 1};
+				if (blockedAt(x, y - 1))
+					directions[count++] = {dx, -1};
+			} else {
+				directions[count++] = {0, dy};
+				if (blockedAt(x + 1, y))
+					directions[count++] = {1, dy};
+				if (blockedAt(x - 1, y))
+					directions[count++] = {-1, dy};
+			}
+		}
+
+		for (std::size_t i = 0; i < count; ++i) {
+			const auto [dx, dy] = directions[i];
+			const auto steps = jump(x, y, dx, dy, end_x, end_y);
+			if (steps == 0)
+				continue;
+			const auto next_x = x + dx * static_cast<std::ptrdiff_t>(steps);
+			const auto next_y = y + dy * static_cast<std::ptrdiff_t>(steps);
+			const auto next = static_cast<std::size_t>(next_y - 1) * m_width
+				+ static_cast<std::size_t>(next_x - 1);
+			if (workspace.settled(next))
+				continue;
+			const auto step = dx != 0 && dy != 0 ? SQRT_2 : 1.;
+			const auto cost = current_cost + static_cast<double>(steps) * step;
+			if (!workspace.reached(next)) {
+				workspace.reach(next, cost, current);
+				frontier.push(next, cost + heuristic(next_x, next_y));
+			} else if (cost < workspace.distance(next)) {
+				workspace.reach(next, cost, current);
+				frontier.decrease(next, cost + heuristic(next_x, next_y));
+			}
+		}
+	}
+	if (!workspace.reached(end))
+		throw std::runtime_error{"No valid path"};
+
+	// jump points are joined by straight or diagonal segments
+	const auto jump_points = workspace.path(end);
+	std::vector<std::size_t> path{start};
+	for (std::size_t i = 1; i < jump_points.size(); ++i) {
+		const auto to_x = x_of(jump_points[i]);
+		const auto to_y = y_of(jump_points[i]);
+		auto x = x_of(jump_points[i - 1]);
+		auto y = y_of(jump_points[i - 1]);
+		const auto dx = sign(to_x - x);
+		const auto dy = sign(to_y - y);
+		while (x != to_x || y != to_y) {
+			x += dx;
+			y += dy;
+			path.push_back(
+				static_cast<std::size_t>(y - 1) * m_width
+				+ static_cast<std::size_t>(x - 1));
+		}
+	}
+	return std::make_pair(workspace.distance(end), path);
+}
+
+inline std::size_t GridGraph::lowestBit(std::uint64_t bits)
+{
+#if defined(__GNUC__)
+	return static_cast<std::size_t>(__builtin_ctzll(bits));
+#else
+	std::size_t index = 0;
+	for (; !(bits & 1); bits >>= 1)
+		++index;
+	return index;
+#endif
+}
+
+inline double GridGraph::distance(std::ptrdiff_t dx, std::ptrdiff_t dy)
+{
+	const auto a = std::abs(dx);
+	const auto b = std::abs(dy);
+	const auto diagonal = static_cast<double>(a < b ? a : b);
+	const auto straight = static_cast<double>(a < b ? b - a : a - b);
+	return diagonal * SQRT_2 + straight;
+}
+
+inline bool GridGraph::blockedAt(std::ptrdiff_t x, std::ptrdiff_t y) const
+{
+	return m_bitmaps[EAST].test(
+		static_cast<std::size_t>(y), static_cast<std::size_t>(x));
+}
+
+inline std::pair<std::size_t, bool>
+GridGraph::scan(Direction direction, std::ptrdiff_t x, std::ptrdiff_t y) const
+{
+	// position in the bitmap scanned forwards for the direction
+	auto row = static_cast<std::size_t>(y);
+	auto column = static_cast<std::size_t>(x);
+	if (direction == WEST) {
+		column = m_width + 1 - column;
+	} else if (direction == SOUTH) {
+		row = static_cast<std::size_t>(x);
+		column = static_cast<std::size_t>(y);
+	} else if (direction == NORTH) {
+		row = static_cast<std::size_t>(x);
+		column = m_height + 1 - static_cast<std::size_t>(y);
+	}
+	const auto& bitmap = m_bitmaps[direction];
+
+	// bit j of a window is the cell j steps ahead, the cell j has a forced
+	// neighbour if the cell beside it is blocked and the one after that is
+	// free, which is only known for j < 63
+	constexpr std::uint64_t AHEAD = 0x7ffffffffffffffe;
+	for (std::size_t steps = 0;; steps += 62) {
+		const auto wall = bitmap.window(row, column + steps) & ~1ull;
+		const auto left = bitmap.window(row - 1, column + steps);
+		const auto right = bitmap.window(row + 1, column + steps);
+		const auto forced
+			= ((left & ~(left >> 1)) | (right & ~(right >> 1))) & AHEAD;
+		if (wall == 0 && forced == 0)
+			continue;
+		// the border stops every scan
+		const auto to_wall = wall != 0 ? lowestBit(wall) : 64;
+		const auto to_forced = forced != 0 ? lowestBit(forced) : 64;
+		if (to_forced < to_wall)
+			return {steps + to_forced, true};
+		return {steps + to_wall - 1, false};
+	}
+}
+
+inline std::size_t GridGraph::jump(
+	std::ptrdiff_t x,
+	std::ptrdiff_t y,
+	int dx,
+	int dy,
+	std::ptrdiff_t end_x,
+	std::ptrdiff_t end_y) const
+{
+	if (dx == 0 || dy == 0) {
+		const auto direction
+			= dy == 0 ? (dx > 0 ? EAST : WEST) : (dy > 0 ? SOUTH : NORTH);
+		const auto [steps, forced] = scan(direction, x, y);
+		// the end on the way is a jump point too
+		const auto ahead = dy == 0 ? (end_x - x) * dx : (end_y - y) * dy;
+		const auto aside = dy == 0 ? end_y - y : end_x - x;
+		if (aside == 0 && ahead > 0
+			&& static_cast<std::size_t>(ahead) <= steps)
+			return static_cast<std::size_t>(ahead);
+		return forced ? steps : 0;
+	}
+
+	for (std::size_t steps = 1;; ++steps) {
+		x += dx;
+		y += dy;
+		if (blockedAt(x, y))
+			return 0;
+		if (x == end_x && y == end_y)
+			return steps;
+		if ((blockedAt(x - dx, y) && !blockedAt(x - dx, y + dy))
+			|| (blockedAt(x, y - dy) && !blockedAt(x + dx, y - dy)))
+			return steps;
+		if (jump(x, y, dx, 0, end_x, end_y) != 0
+			|| jump(x, y, 0, dy, end_x, end_y) != 0)
+			return steps;
+	}
+}
+
+inline void GridGraph::Bitmap::assign(std::size_t rows, std::size_t columns)
+{
+	// a spare word at the end of every row for windows crossing it
+	stride = (columns + 63) / 64 + 1;
+	words.assign(rows * stride, ~0ull);
+}
+
+inline bool GridGraph::Bitmap::test(std::size_t row, std::size_t column) const
+{
+	return (words[row * stride + column / 64] >> (column % 64)) & 1;
+}
+
+inline void
+GridGraph::Bitmap::set(std::size_t row, std::size_t column, bool value)
+{
+	auto& word = words[row * stride + column / 64];
+	const auto bit = 1ull << (column % 64);
+	word = value ? word | bit : word & ~bit;
+}
+
+inline std::uint64_t
+GridGraph::Bitmap::window(std::size_t row, std::size_t column) const
+{
+	const auto* first = words.data() + row * stride + column / 64;
+	const auto shift = column % 64;
+	if (shift == 0)
+		return first[0];
+	return (first[0] >> shift) | (first[1] << (64 - shift));
+}
+
+#endif /* GRIDGRAPH_HPP */
@@ -0,0 +1,485 @@
+#ifndef HUBLABELS_HPP
+#define HUBLABELS_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fcntl.h>
+#include <istream>
+#include <limits>
+#include <memory>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <tuple>
+#include <type_traits>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+
+#include "Graph.hpp"
+#include "SearchWorkspace.hpp"
+
+// distance oracle built with pruned landmark labeling: every vertex has an
+// out label (hub, d(v, hub)) and an in label (hub, d(hub, v)), sorted by hub,
+// and d(s, t) is the minimum over the hubs common to out(s) and in(t)
+// the labels live in one buffer with the same layout as the saved file, so a
+// file can be memory mapped and queried without loading it
+class HubLabels {
+public:
+	HubLabels() = default;
+	// an owned buffer is copied, a mapping is shared
+	HubLabels(const HubLabels&);
+	HubLabels(HubLabels&&) = default;
+	HubLabels& operator=(const HubLabels&);
+	HubLabels& operator=(HubLabels&&) = default;
+	~HubLabels() = default;
+
+	template <typename V, typename E, typename F>
+	static HubLabels build(const Graph<V, E>&, F);
+
+	std::size_t nrOfVertices() const;
+	// total number of label entries in both directions
+	std::size_t size() const;
+
+	// infinity if there is no path
+	double distance(std::size_t, std::size_t) const;
+
+	// load() and map() check the labels before using them and throw
+	// std::runtime_error if they are not well formed
+	void save(std::ostream&) const;
+	static HubLabels load(std::istream&);
+	// the mapping is shared by copies and released with the last one
+	static HubLabels map(const std::string&);
+
+private:
+	static constexpr double INF = std::numeric_limits<double>::infinity();
+	// ends every label, bigger than any hub so a merge needs no bounds check
+	static constexpr std::uint32_t SENTINEL
+		= std::numeric_limits<std::uint32_t>::max();
+	static constexpr char MAGIC[4] = {'H', 'L', '0', '1'};
+
+	struct Header {
+		char magic[4];
+		std::uint32_t reserved;
+		std::uint64_t vertices;
+		// entries of all labels in one direction, sentinels included
+		std::uint64_t out_entries;
+		std::uint64_t in_entries;
+	};
+
+	// one direction, hubs and distances of a label are separate arrays
+	struct Labels {
+		const std::uint64_t* offsets;
+		const std::uint32_t* hubs;
+		const double* distances;
+	};
+
+	using Label = std::vector<std::pair<std::uint32_t, double>>;
+
+	// layout after the header, everything stays 8 byte aligned: out
+	// offsets, in offsets, out distances, in distances, out hubs, in hubs
+	static std::size_t bytes(const Header&);
+	static std::pair<Labels, Labels> split(const unsigned char*, const Header&);
+	// the header describes at most the given number of bytes
+	static bool validHeader(const Header&, std::size_t);
+	// offsets go up to the number of entries, every label is sorted, ends
+	// with the sentinel and has hubs lower than the number of vertices
+	static bool validLabels(const Labels&, const Header&, std::uint64_t);
+	void attach(const unsigned char*);
+	void pack(const std::vector<Label>&, const std::vector<Label>&);
+
+	// owned buffer or a mapped file
+	std::vector<std::uint64_t> m_buffer{};
+	std::shared_ptr<const unsigned char> m_mapping{};
+	Header m_header{{}, 0, 0, 0, 0};
+	Labels m_out{nullptr, nullptr, nullptr};
+	Labels m_in{nullptr, nullptr, nullptr};
+};
+
+////////////////////////////////////////
+// HubLabels implementation
+////////////////////////////////////////
+
+inline HubLabels::HubLabels(const HubLabels& other)
+	: m_buffer{other.m_buffer}
+	, m_mapping{other.m_mapping}
+	, m_header{other.m_header}
+	, m_out{other.m_out}
+	, m_in{other.m_in}
+{
+	// the labels of the source point into its own buffer
+	if (!m_mapping && !m_buffer.empty())
+		attach(reinterpret_cast<const unsigned char*>(m_buffer.data()));
+}
+
+inline HubLabels& HubLabels::operator=(const HubLabels& other)
+{
+	if (this != &other) {
+		m_buffer = other.m_buffer;
+		m_mapping = other.m_mapping;
+		m_header = other.m_header;
+		m_out = other.m_out;
+		m_in = other.m_in;
+		if (!m_mapping && !m_buffer.empty())
+			attach(reinterpret_cast<const unsigned char*>(m_buffer.data()));
+	}
+	return *this;
+}
+
+template <typename V, typename E, typename F>
+HubLabels HubLabels::build(const Graph<V, E>& graph, F f)
+{
+	const auto vertices = graph.nrOfVertices();
+
+	// flat adjacency in both directions
+	std::vector<std::size_t> out_offsets(vertices + 1, 0);
+	std::vector<std::size_t> in_offsets(vertices + 1, 0);
+	for (auto it = graph.beginEdges(); it != graph.endEdges(); ++it) {
+		++out_offsets[it.v1id() + 1];
+		++in_offsets[it.v2id() + 1];
+	}
+	for (std::size_t i = 0; i < vertices; ++i) {
+		out_offsets[i + 1] += out_offsets[i];
+		in_offsets[i + 1] += in_offsets[i];
+	}
+	std::vector<std::pair<std::size_t, double>> out_edges(
+		out_offsets.back());
+	std::vector<std::pair<std::size_t, double>> in_edges(in_offsets.back());
+	{
+		auto out_end = out_offsets;
+		auto in_end = in_offsets;
+		for (auto it = graph.beginEdges(); it != graph.endEdges(); ++it) {
+			const auto value = f(*it);
+			if constexpr (std::is_signed_v<EdgeLength<F, E>>)
+				if (value < 0)
+					throw std::domain_error{"Ujemna długość krawędzi"};
+			const auto length = static_cast<double>(value);
+			out_edges[out_end[it.v1id()]++] = {it.v2id(), length};
+			in_edges[in_end[it.v2id()]++] = {it.v1id(), length};
+		}
+	}
+
+	// hubs are processed by decreasing degree product, a hub is stored as
+	// its position in that order, so labels are sorted as they grow
+	std::vector<std::size_t> order(vertices);
+	for (std::size_t i = 0; i < vertices; ++i)
+		order[i] = i;
+	const auto degree = [&](std::size_t node) {
+		return (out_offsets[node + 1] - out_offsets[node] + 1)
+			* (in_offsets[node + 1] - in_offsets[node] + 1);
+	};
+	std::stable_sort(
+		order.begin(), order.end(), [&](std::size_t a, std::size_t b) {
+			return degree(a) > degree(b);
+		});
+
+	std::vector<Label> out_labels(vertices);
+	std::vector<Label> in_labels(vertices);
+	// label of the current hub spread over an array indexed by hub
+	std::vector<double> root(vertices, INF);
+	SearchWorkspace<double> workspace{};
+
+	// Dijkstra from the hub which does not expand vertices already covered
+	// by the labels, forward it fills in labels, backward out labels
+	const auto prunedSearch = [&](
+		std::size_t hub,
+		std::uint32_t id,
+		const std::vector<std::size_t>& offsets,
+		const std::vector<std::pair<std::size_t, double>>& edges,
+		const Label& hub_label,
+		std::vector<Label>& labels) {
+		for (const auto& [other, length] : hub_label)
+			root[other] = length;
+		workspace.reset(vertices);
+		auto& frontier = workspace.heap();
+		workspace.reach(hub, 0, hub);
+		frontier.push(hub, 0);
+		while (!frontier.empty()) {
+			const auto current = frontier.top();
+			frontier.pop();
+			workspace.settle(current);
+			const auto cost = workspace.distance(current);
+			const auto covered = std::any_of(
+				labels[current].begin(),
+				labels[current].end(),
+				[&](const std::pair<std::uint32_t, double>& entry) {
+					return root[entry.first] + entry.second <= cost;
+				});
+			if (covered)
+				continue;
+			labels[current].emplace_back(id, cost);
+			for (auto i = offsets[current]; i < offsets[current + 1]; ++i) {
+				const auto [node, length] = edges[i];
+				if (workspace.settled(node))
+					continue;
+				if (!workspace.reached(node)) {
+					workspace.reach(node, cost + length, current);
+					frontier.push(node, cost + length);
+				} else if (cost + length < workspace.distance(node)) {
+					workspace.reach(node, cost + length, current);
+					frontier.decrease(node, cost + length);
+				}
+			}
+		}
+		for (const auto& [other, length] : hub_label)
+			root[other] = INF;
+	};
+
+	for (std::size_t position = 0; position < vertices; ++position) {
+		const auto hub = order[position];
+		const auto id = static_cast<std::uint32_t>(position);
+		prunedSearch(
+			hub, id, out_offsets, out_edges, out_labels[hub], in_labels);
+		prunedSearch(
+			hub, id, in_offsets, in_edges, in_labels[hub], out_labels);
+	}
+
+	HubLabels out{};
+	out.pack(out_labels, in_labels);
+	return out;
+}
+
+inline std::size_t HubLabels::nrOfVertices() const
+{
+	return m_header.vertices;
+}
+
+inline std::size_t HubLabels::size() const
+{
+	return m_header.out_entries + m_header.in_entries
+		- 2 * m_header.vertices;
+}
+
+inline double HubLabels::distance(std::size_t start, std::size_t end) const
+{
+	// merge of two sorted labels, both end with the same sentinel
+	const auto* out_hubs = m_out.hubs + m_out.offsets[start];
+	const auto* out_distances = m_out.distances + m_out.offsets[start];
+	const auto* in_hubs = m_in.hubs + m_in.offsets[end];
+	const auto* in_distances = m_in.distances + m_in.offsets[end];
+	double out = INF;
+	while (true) {
+		const auto a = *out_hubs;
+		const auto b = *in_hubs;
+		if (a == b) {
+			if (a == SENTINEL)
+				break;
+			out = std::min(out, *out_distances + *in_distances);
+		}
+		// advance the smaller side, both on a match
+		const auto step_out = a <= b;
+		const auto step_in = b <= a;
+		out_hubs += step_out;
+		out_distances += step_out;
+		in_hubs += step_in;
+		in_distances += step_in;
+	}
+	return out;
+}
+
+inline void HubLabels::save(std::ostream& stream) const
+{
+	const auto* data = m_mapping
+		? m_mapping.get()
+		: reinterpret_cast<const unsigned char*>(m_buffer.data());
+	stream.write(
+		reinterpret_cast<const char*>(data),
+		static_cast<std::streamsize>(bytes(m_header)));
+	if (!stream)
+		throw std::runtime_error{"Nie udało się zapisać etykiet"};
+}
+
+inline HubLabels HubLabels::load(std::istream& stream)
+{
+	Header header{};
+	stream.read(reinterpret_cast<char*>(&header), sizeof(header));
+	if (!stream
+		|| !std::equal(header.magic, header.magic + sizeof(MAGIC), MAGIC))
+		throw std::runtime_error{"To nie jest plik etykiet"};
+	// the rest of a seekable stream bounds the size before allocation
+	auto available = std::numeric_limits<std::size_t>::max();
+	const auto position = stream.tellg();
+	if (position != std::istream::pos_type(-1)) {
+		stream.seekg(0, std::ios::end);
+		available = sizeof(header)
+			+ static_cast<std::size_t>(stream.tellg() - position);
+		stream.seekg(position);
+	}
+	if (!validHeader(header, available))
+		throw std::runtime_error{"Uszkodzony plik etykiet"};
+
+	HubLabels out{};
+	const auto size = bytes(header);
+	out.m_buffer.resize(size / sizeof(std::uint64_t));
+	auto* data = reinterpret_cast<unsigned char*>(out.m_buffer.data());
+	std::memcpy(data, &header, sizeof(header));
+	stream.read(
+		reinterpret_cast<char*>(data + sizeof(header)),
+		static_cast<std::streamsize>(size - sizeof(header)));
+	const auto [out_labels, in_labels] = split(data, header);
+	if (!stream || !validLabels(out_labels, header, header.out_entries)
+		|| !validLabels(in_labels, header, header.in_entries))
+		throw std::runtime_error{"Uszkodzony plik etykiet"};
+	out.attach(data);
+	return out;
+}
+
+inline HubLabels HubLabels::map(const std::string& path)
+{
+	const auto file = ::open(path.c_str(), O_RDONLY);
+	if (file < 0)
+		throw std::runtime_error{"Nie można otworzyć pliku etykiet"};
+	struct stat info {};
+	if (::fstat(file, &info) != 0
+		|| static_cast<std::size_t>(info.st_size) < sizeof(Header)) {
+		::close(file);
+		throw std::runtime_error{"To nie jest plik etykiet"};
+	}
+	const auto length = static_cast<std::size_t>(info.st_size);
+	auto* address = ::mmap(nullptr, length, PROT_READ, MAP_SHARED, file, 0);
+	::close(file);
+	if (address == MAP_FAILED)
+		throw std::runtime_error{"Nie można zmapować pliku etykiet"};
+
+	HubLabels out{};
+	out.m_mapping = std::shared_ptr<const unsigned char>(
+		static_cast<const unsigned char*>(address),
+		[length](const unsigned char* data) {
+			::munmap(const_cast<unsigned char*>(data), length);
+		});
+	const auto* data = out.m_mapping.get();
+	Header header{};
+	std::memcpy(&header, data, sizeof(Header));
+	if (!std::equal(MAGIC, MAGIC + sizeof(MAGIC), header.magic))
+		throw std::runtime_error{"To nie jest plik etykiet"};
+	// a saved file has exactly the size given by its header
+	if (!validHeader(header, length) || bytes(header) != length)
+		throw std::runtime_error{"Uszkodzony plik etykiet"};
+	const auto [out_labels, in_labels] = split(data, header);
+	if (!validLabels(out_labels, header, header.out_entries)
+		|| !validLabels(in_labels, header, header.in_entries))
+		throw std::runtime_error{"Uszkodzony plik etykiet"};
+	out.attach(data);
+	return out;
+}
+
+inline std::size_t HubLabels::bytes(const Header& header)
+{
+	const auto offsets = 2 * (header.vertices + 1) * sizeof(std::uint64_t);
+	const auto entries = header.out_entries + header.in_entries;
+	const auto size = sizeof(Header) + offsets
+		+ entries * (sizeof(double) + sizeof(std::uint32_t));
+	// rounded up to whole words of the owned buffer
+	return (size + sizeof(std::uint64_t) - 1) / sizeof(std::uint64_t)
+		* sizeof(std::uint64_t);
+}
+
+inline std::pair<HubLabels::Labels, HubLabels::Labels>
+HubLabels::split(const unsigned char* data, const Header& header)
+{
+	auto position = data + sizeof(Header);
+	const auto take = [&position](std::size_t size) {
+		const auto* out = position;
+		position += size;
+		return out;
+	};
+	Labels out{nullptr, nullptr, nullptr};
+	Labels in{nullptr, nullptr, nullptr};
+	const auto offsets = (header.vertices + 1) * sizeof(std::uint64_t);
+	out.offsets = reinterpret_cast<const std::uint64_t*>(take(offsets));
+	in.offsets = reinterpret_cast<const std::uint64_t*>(take(offsets));
+	out.distances = reinterpret_cast<const double*>(
+		take(header.out_entries * sizeof(double)));
+	in.distances = reinterpret_cast<const double*>(
+		take(header.in_entries * sizeof(double)));
+	out.hubs = reinterpret_cast<const std::uint32_t*>(
+		take(header.out_entries * sizeof(std::uint32_t)));
+	in.hubs = reinterpret_cast<const std::uint32_t*>(
+		take(header.in_entries * sizeof(std::uint32_t)));
+	return std::make_pair(out, in);
+}
+
+inline bool HubLabels::validHeader(const Header& header, std::size_t length)
+{
+	// hubs are 32 bit, limits on the counts keep bytes() from overflowing
+	constexpr std::uint64_t max_entries = std::uint64_t{1} << 58;
+	return header.vertices < SENTINEL
+		&& header.out_entries >= header.vertices
+		&& header.in_entries >= header.vertices
+		&& header.out_entries <= max_entries
+		&& header.in_entries <= max_entries && bytes(header) <= length;
+}
+
+inline bool HubLabels::validLabels(
+	const Labels& labels,
+	const Header& header,
+	std::uint64_t entries)
+{
+	const auto vertices = header.vertices;
+	if (labels.offsets[0] != 0 || labels.offsets[vertices] != entries)
+		return false;
+	for (std::size_t i = 0; i < vertices; ++i) {
+		const auto begin = labels.offsets[i];
+		const auto end = labels.offsets[i + 1];
+		// at least the sentinel
+		if (end <= begin || end > entries)
+			return false;
+		if (labels.hubs[end - 1] != SENTINEL)
+			return false;
+		for (auto j = begin; j + 1 < end; ++j)
+			if (labels.hubs[j] >= vertices
+				|| (j > begin && labels.hubs[j] <= labels.hubs[j - 1]))
+				return false;
+	}
+	return true;
+}
+
+inline void HubLabels::attach(const unsigned char* data)
+{
+	std::memcpy(&m_header, data, sizeof(Header));
+	std::tie(m_out, m_in) = split(data, m_header);
+}
+
+inline void HubLabels::pack(
+	const std::vector<Label>& out_labels,
+	const std::vector<Label>& in_labels)
+{
+	const auto count = [](const std::vector<Label>& labels) {
+		std::uint64_t out = 0;
+		for (const auto& label : labels)
+			out += label.size() + 1;
+		return out;
+	};
+	Header header{{}, 0, out_labels.size(), 0, 0};
+	std::copy(MAGIC, MAGIC + sizeof(MAGIC), header.magic);
+	header.out_entries = count(out_labels);
+	header.in_entries = count(in_labels);
+	m_buffer.assign(bytes(header) / sizeof(std::uint64_t), 0);
+	auto* data = reinterpret_cast<unsigned char*>(m_buffer.data());
+	std::memcpy(data, &header, sizeof(header));
+	attach(data);
+
+	const auto fill = [](const std::vector<Label>& labels, Labels& target) {
+		auto* offsets = const_cast<std::uint64_t*>(target.offsets);
+		auto* hubs = const_cast<std::uint32_t*>(target.hubs);
+		auto* distances = const_cast<double*>(target.distances);
+		std::uint64_t position = 0;
+		for (std::size_t i = 0; i < labels.size(); ++i) {
+			offsets[i] = position;
+			for (const auto& [hub, length] : labels[i]) {
+				hubs[position] = hub;
+				distances[position++] = length;
+			}
+			hubs[position] = SENTINEL;
+			distances[position++] = INF;
+		}
+		offsets[labels.size()] = position;
+	};
+	fill(out_labels, m_out);
+	fill(in_labels, m_in);
+}
+
+#endif /* HUBLABELS_HPP */
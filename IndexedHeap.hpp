@@ -0,0 +1,163 @@
+#ifndef INDEXEDHEAP_HPP
+#define INDEXEDHEAP_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+// d-ary min-heap of vertex ids with a position map, so a vertex is stored at
+// most once and its key can be decreased in place
+// heaps used by the shortest path algorithms provide the same interface:
+// clear(n), empty(), contains(id), top(), topKey(), push(id, key),
+// decrease(id, key) and pop()
+template <typename Key, std::size_t D = 4>
+class IndexedHeap {
+	static_assert(D >= 2, "heap arity must be at least 2");
+
+public:
+	IndexedHeap() = default;
+	IndexedHeap(const IndexedHeap&) = default;
+	IndexedHeap(IndexedHeap&&) = default;
+	IndexedHeap& operator=(const IndexedHeap&) = default;
+	IndexedHeap& operator=(IndexedHeap&&) = default;
+	~IndexedHeap() = default;
+
+	// empties the heap and makes room for ids lower than the argument
+	void clear(std::size_t);
+	bool empty() const;
+	std::size_t size() const;
+	bool contains(std::size_t) const;
+
+	std::size_t top() const;
+	Key topKey() const;
+
+	// the id must not be in the heap
+	void push(std::size_t, Key);
+	// the new key must not be greater than the current one
+	void decrease(std::size_t, Key);
+	void pop();
+
+private:
+	static constexpr auto NONE = std::numeric_limits<std::size_t>::max();
+
+	void siftUp(std::size_t, std::pair<Key, std::size_t>);
+	void siftDown(std::size_t, std::pair<Key, std::size_t>);
+
+	std::vector<std::pair<Key, std::size_t>> m_heap{};
+	std::vector<std::size_t> m_position{};
+};
+
+////////////////////////////////////////
+// IndexedHeap implementation
+////////////////////////////////////////
+
+template <typename Key, std::size_t D>
+void IndexedHeap<Key, D>::clear(std::size_t ids)
+{
+	// only the ids still in the heap have a position set
+	for (const auto& elem : m_heap)
+		m_position[elem.second] = NONE;
+	m_heap.clear();
+	if (m_position.size() < ids)
+		m_position.resize(ids, NONE);
+}
+
+template <typename Key, std::size_t D>
+bool IndexedHeap<Key, D>::empty() const
+{
+	return m_heap.empty();
+}
+
+template <typename Key, std::size_t D>
+std::size_t IndexedHeap<Key, D>::size() const
+{
+	return m_heap.size();
+}
+
+template <typename Key, std::size_t D>
+bool IndexedHeap<Key, D>::contains(std::size_t id) const
+{
+	return m_position[id] != NONE;
+}
+
+template <typename Key, std::size_t D>
+std::size_t IndexedHeap<Key, D>::top() const
+{
+	return m_heap.front().second;
+}
+
+template <typename Key, std::size_t D>
+Key IndexedHeap<Key, D>::topKey() const
+{
+	return m_heap.front().first;
+}
+
+template <typename Key, std::size_t D>
+void IndexedHeap<Key, D>::push(std::size_t id, Key key)
+{
+	m_heap.emplace_back();
+	siftUp(m_heap.size() - 1, {key, id});
+}
+
+template <typename Key, std::size_t D>
+void IndexedHeap<Key, D>::decrease(std::size_t id, Key key)
+{
+	siftUp(m_position[id], {key, id});
+}
+
+template <typename Key, std::size_t D>
+void IndexedHeap<Key, D>::pop()
+{
+	m_position[m_heap.front().second] = NONE;
+	const auto last = m_heap.back();
+	m_heap.pop_back();
+	if (!m_heap.empty())
+		siftDown(0, last);
+}
+
+template <typename Key, std::size_t D>
+void IndexedHeap<Key, D>::siftUp(
+	std::size_t hole,
+	std::pair<Key, std::size_t> elem)
+{
+	// move parents down until elem fits, then write it once
+	while (hole > 0) {
+		const auto parent = (hole - 1) / D;
+		if (!(elem.first < m_heap[parent].first))
+			break;
+		m_heap[hole] = m_heap[parent];
+		m_position[m_heap[hole].second] = hole;
+		hole = parent;
+	}
+	m_heap[hole] = elem;
+	m_position[elem.second] = hole;
+}
+
+template <typename Key, std::size_t D>
+void IndexedHeap<Key, D>::siftDown(
+	std::size_t hole,
+	std::pair<Key, std::size_t> elem)
+{
+	const auto count = m_heap.size();
+	while (true) {
+		const auto first = hole * D + 1;
+		if (first >= count)
+			break;
+		const auto last = std::min(first + D, count);
+		auto best = first;
+		for (auto i = first + 1; i < last; ++i)
+			if (m_heap[i].first < m_heap[best].first)
+				best = i;
+		if (!(m_heap[best].first < elem.first))
+			break;
+		m_heap[hole] = m_heap[best];
+		m_position[m_heap[hole].second] = hole;
+		hole = best;
+	}
+	m_heap[hole] = elem;
+	m_position[elem.second] = hole;
+}
+
+#endif /* INDEXEDHEAP_HPP */
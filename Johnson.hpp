@@ -0,0 +1,189 @@
+#ifndef JOHNSON_HPP
+#define JOHNSON_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "Graph.hpp"
+#include "SearchWorkspace.hpp"
+
+// Johnson's reweighting for graphs with negative edge lengths: potentials
+// from one Bellman-Ford run make every length l(u, v) + h(u) - h(v)
+// non-negative, after that every query is a plain Dijkstra
+// the lengths are copied, the graph is not needed after build
+class Johnson {
+public:
+	Johnson() = default;
+	Johnson(const Johnson&) = default;
+	Johnson(Johnson&&) = default;
+	Johnson& operator=(const Johnson&) = default;
+	Johnson& operator=(Johnson&&) = default;
+	~Johnson() = default;
+
+	// throws domain_error if the graph has a negative cycle, threads as in
+	// Graph::bellmanFord
+	template <typename V, typename E, typename F>
+	static Johnson build(const Graph<V, E>&, F, std::size_t = 0);
+
+	std::size_t nrOfVertices() const;
+	const std::vector<double>& potentials() const;
+
+	// same result as Graph::dijkstra would give if it allowed negative
+	// lengths
+	std::pair<double, std::vector<std::size_t>>
+	query(std::size_t, std::size_t) const;
+	std::pair<double, std::vector<std::size_t>> query(
+		std::size_t,
+		std::size_t,
+		SearchWorkspace<double>&) const;
+	// distances from the source to every vertex (infinity - no path)
+	std::vector<double> distances(std::size_t) const;
+	std::vector<double>
+	distances(std::size_t, SearchWorkspace<double>&) const;
+
+private:
+	struct Edge {
+		std::size_t node;
+		double length;
+		// never negative
+		double reduced;
+	};
+
+	// Dijkstra on reduced lengths, stops after settling the end (if any)
+	void search(std::size_t, std::size_t, SearchWorkspace<double>&) const;
+
+	std::vector<double> m_potentials{};
+	std::vector<std::size_t> m_offsets{0};
+	std::vector<Edge> m_edges{};
+};
+
+////////////////////////////////////////
+// Johnson implementation
+////////////////////////////////////////
+
+template <typename V, typename E, typename F>
+Johnson Johnson::build(const Graph<V, E>& graph, F f, std::size_t threads)
+{
+	const auto vertices = graph.nrOfVertices();
+	// an extra source with zero length edges to all vertices is the same as
+	// every vertex being a source
+	std::vector<std::size_t> sources(vertices);
+	for (std::size_t i = 0; i < vertices; ++i)
+		sources[i] = i;
+
+	Johnson out{};
+	out.m_potentials = graph.bellmanFord(sources, f, threads).distance;
+	out.m_offsets.assign(vertices + 1, 0);
+	for (auto it = graph.beginEdges(); it != graph.endEdges(); ++it)
+		++out.m_offsets[it.v1id() + 1];
+	for (std::size_t i = 0; i < vertices; ++i)
+		out.m_offsets[i + 1] += out.m_offsets[i];
+	out.m_edges.resize(out.m_offsets.back());
+	auto next = out.m_offsets;
+	for (auto it = graph.beginEdges(); it != graph.endEdges(); ++it) {
+		const auto length = static_cast<double>(f(*it));
+		// rounding may leave a tiny negative value
+		const auto reduced = std::max(
+			0.,
+			length + out.m_potentials[it.v1id()]
+				- out.m_potentials[it.v2id()]);
+		out.m_edges[next[it.v1id()]++] = {it.v2id(), length, reduced};
+	}
+	return out;
+}
+
+inline std::size_t Johnson::nrOfVertices() const
+{
+	return m_potentials.size();
+}
+
+inline const std::vector<double>& Johnson::potentials() const
+{
+	return m_potentials;
+}
+
+inline std::pair<double, std::vector<std::size_t>>
+Johnson::query(std::size_t start, std::size_t end) const
+{
+	SearchWorkspace<double> workspace{};
+	return query(start, end, workspace);
+}
+
+inline std::pair<double, std::vector<std::size_t>> Johnson::query(
+	std::size_t start,
+	std::size_t end,
+	SearchWorkspace<double>& workspace) const
+{
+	search(start, end, workspace);
+	if (!workspace.settled(end))
+		throw std::runtime_error{"No valid path"};
+	// the length is summed again from the original lengths
+	auto path = workspace.path(end);
+	double length = 0;
+	for (std::size_t i = 1; i < path.size(); ++i) {
+		const auto first = m_edges.begin() + m_offsets[path[i - 1]];
+		const auto last = m_edges.begin() + m_offsets[path[i - 1] + 1];
+		length += std::find_if(first, last, [&](const Edge& edge) {
+					  return edge.node == path[i];
+				  })->length;
+	}
+	return std::make_pair(length, path);
+}
+
+inline std::vector<double> Johnson::distances(std::size_t source) const
+{
+	SearchWorkspace<double> workspace{};
+	return distances(source, workspace);
+}
+
+inline std::vector<double>
+Johnson::distances(std::size_t source, SearchWorkspace<double>& workspace)
+	const
+{
+	search(source, nrOfVertices(), workspace);
+	std::vector<double> out(
+		nrOfVertices(), std::numeric_limits<double>::infinity());
+	for (std::size_t i = 0; i < nrOfVertices(); ++i)
+		if (workspace.settled(i))
+			out[i] = workspace.distance(i) - m_potentials[source]
+				+ m_potentials[i];
+	return out;
+}
+
+inline void Johnson::search(
+	std::size_t start,
+	std::size_t end,
+	SearchWorkspace<double>& workspace) const
+{
+	workspace.reset(nrOfVertices());
+	auto& frontier = workspace.heap();
+	workspace.reach(start, 0, start);
+	frontier.push(start, 0);
+	while (!frontier.empty()) {
+		const auto current = frontier.top();
+		frontier.pop();
+		workspace.settle(current);
+		if (current == end)
+			return;
+		const auto cost = workspace.distance(current);
+		for (auto i = m_offsets[current]; i < m_offsets[current + 1]; ++i) {
+			const auto& edge = m_edges[i];
+			if (workspace.settled(edge.node))
+				continue;
+			const auto next = cost + edge.reduced;
+			if (!workspace.reached(edge.node)) {
+				workspace.reach(edge.node, next, current);
+				frontier.push(edge.node, next);
+			} else if (next < workspace.distance(edge.node)) {
+				workspace.reach(edge.node, next, current);
+				frontier.decrease(edge.node, next);
+			}
+		}
+	}
+}
+
+#endif /* JOHNSON_HPP */
@@ -0,0 +1,322 @@
+#ifndef LANDMARKS_HPP
+#define LANDMARKS_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "Graph.hpp"
+#include "SearchWorkspace.hpp"
+
+// ALT preprocessing (A*, landmarks, triangle inequality): exact distances
+// from and to a few landmark vertices give a lower bound on the distance
+// between any two vertices, for every edge length function
+// the bound is a consistent heuristic, so it can be passed to a_star/astar
+class Landmarks {
+public:
+	enum class Selection {
+		// the vertex farthest from the landmarks chosen so far
+		FARTHEST,
+		// a leaf of the biggest shortest path subtree with a poor bound
+		AVOID
+	};
+
+	Landmarks() = default;
+	Landmarks(const Landmarks&) = default;
+	Landmarks(Landmarks&&) = default;
+	Landmarks& operator=(const Landmarks&) = default;
+	Landmarks& operator=(Landmarks&&) = default;
+	~Landmarks() = default;
+
+	template <typename V, typename E, typename F>
+	static Landmarks build(
+		const Graph<V, E>&,
+		F,
+		std::size_t,
+		Selection = Selection::AVOID);
+
+	std::size_t nrOfVertices() const;
+	const std::vector<std::size_t>& landmarks() const;
+
+	// lower bound on the distance from the first vertex to the second one,
+	// infinity if the second one is known to be unreachable
+	double lowerBound(std::size_t, std::size_t) const;
+	// lowerBound with the signature of an A* heuristic, the object must
+	// outlive it and the graph must not change
+	auto heuristic() const;
+
+private:
+	static constexpr double INF = std::numeric_limits<double>::infinity();
+
+	// outgoing (or incoming) edges of every vertex
+	struct Adjacency {
+		std::vector<std::size_t> offsets{};
+		std::vector<std::pair<std::size_t, double>> edges{};
+	};
+
+	static void search(
+		const Adjacency&,
+		std::size_t,
+		SearchWorkspace<double>&,
+		std::vector<std::size_t>&);
+	void add(
+		std::size_t,
+		const Adjacency&,
+		const Adjacency&,
+		SearchWorkspace<double>&);
+	std::size_t farthest(const std::vector<double>&) const;
+	std::size_t avoid(
+		const std::vector<double>&,
+		const Adjacency&,
+		SearchWorkspace<double>&) const;
+
+	std::size_t m_vertices{0};
+	// row length of the tables
+	std::size_t m_capacity{0};
+	std::vector<std::size_t> m_landmarks{};
+	// distance from (to) landmark i at [vertex * m_capacity + i], so both
+	// rows used by a bound are contiguous
+	std::vector<double> m_from{};
+	std::vector<double> m_to{};
+};
+
+////////////////////////////////////////
+// Landmarks implementation
+////////////////////////////////////////
+
+template <typename V, typename E, typename F>
+Landmarks Landmarks::build(
+	const Graph<V, E>& graph,
+	F f,
+	std::size_t count,
+	Selection selection)
+{
+	Landmarks out{};
+	out.m_vertices = graph.nrOfVertices();
+	out.m_capacity = std::min(count, out.m_vertices);
+	out.m_from.assign(out.m_vertices * out.m_capacity, INF);
+	out.m_to.assign(out.m_vertices * out.m_capacity, INF);
+	if (out.m_capacity == 0)
+		return out;
+
+	// the graph is copied into flat adjacency arrays in both directions
+	Adjacency forward{};
+	Adjacency backward{};
+	forward.offsets.assign(out.m_vertices + 1, 0);
+	backward.offsets.assign(out.m_vertices + 1, 0);
+	for (auto it = graph.beginEdges(); it != graph.endEdges(); ++it) {
+		++forward.offsets[it.v1id() + 1];
+		++backward.offsets[it.v2id() + 1];
+	}
+	for (std::size_t i = 0; i < out.m_vertices; ++i) {
+		forward.offsets[i + 1] += forward.offsets[i];
+		backward.offsets[i + 1] += backward.offsets[i];
+	}
+	forward.edges.resize(forward.offsets.back());
+	backward.edges.resize(backward.offsets.back());
+	auto forward_end = forward.offsets;
+	auto backward_end = backward.offsets;
+	for (auto it = graph.beginEdges(); it != graph.endEdges(); ++it) {
+		const auto value = f(*it);
+		if constexpr (std::is_signed_v<EdgeLength<F, E>>)
+			if (value < 0)
+				throw std::domain_error{"Ujemna długość krawędzi"};
+		const auto length = static_cast<double>(value);
+		forward.edges[forward_end[it.v1id()]++] = {it.v2id(), length};
+		backward.edges[backward_end[it.v2id()]++] = {it.v1id(), length};
+	}
+
+	// closeness - distance to the nearest landmark in either direction,
+	// measured from vertex 0 before the first landmark is chosen
+	SearchWorkspace<double> workspace{};
+	std::vector<std::size_t> order{};
+	std::vector<double> closeness(out.m_vertices, INF);
+	for (const auto* adjacency : {&forward, &backward}) {
+		search(*adjacency, 0, workspace, order);
+		for (const auto node : order)
+			closeness[node]
+				= std::min(closeness[node], workspace.distance(node));
+	}
+
+	while (out.m_landmarks.size() < out.m_capacity) {
+		const auto landmark
+			= selection == Selection::AVOID && !out.m_landmarks.empty()
+			? out.avoid(closeness, forward, workspace)
+			: out.farthest(closeness);
+		if (landmark == out.m_vertices)
+			break;
+		out.add(landmark, forward, backward, workspace);
+		const auto column = out.m_landmarks.size() - 1;
+		if (out.m_landmarks.size() == 1)
+			closeness.assign(out.m_vertices, INF);
+		for (std::size_t i = 0; i < out.m_vertices; ++i) {
+			const auto row = i * out.m_capacity + column;
+			closeness[i] = std::min(
+				{closeness[i], out.m_from[row], out.m_to[row]});
+		}
+	}
+	return out;
+}
+
+inline std::size_t Landmarks::nrOfVertices() const
+{
+	return m_vertices;
+}
+
+inline const std::vector<std::size_t>& Landmarks::landmarks() const
+{
+	return m_landmarks;
+}
+
+inline double Landmarks::lowerBound(std::size_t from, std::size_t to) const
+{
+	// the tables have no rows without landmarks
+	if (m_landmarks.empty())
+		return 0;
+	const auto* from_v = &m_from[from * m_capacity];
+	const auto* from_t = &m_from[to * m_capacity];
+	const auto* to_v = &m_to[from * m_capacity];
+	const auto* to_t = &m_to[to * m_capacity];
+	double out = 0;
+	for (std::size_t i = 0; i < m_landmarks.size(); ++i) {
+		// d(L, t) <= d(L, v) + d(v, t)
+		if (from_v[i] < INF)
+			out = std::max(out, from_t[i] - from_v[i]);
+		// d(v, L) <= d(v, t) + d(t, L)
+		if (to_t[i] < INF)
+			out = std::max(out, to_v[i] - to_t[i]);
+	}
+	return out;
+}
+
+inline auto Landmarks::heuristic() const
+{
+	return [this](const auto&, std::size_t current, std::size_t end) {
+		return lowerBound(current, end);
+	};
+}
+
+inline void Landmarks::search(
+	const Adjacency& adjacency,
+	std::size_t source,
+	SearchWorkspace<double>& workspace,
+	std::vector<std::size_t>& order)
+{
+	// full Dijkstra, order gets the settled vertices
+	order.clear();
+	workspace.reset(adjacency.offsets.size() - 1);
+	auto& frontier = workspace.heap();
+	workspace.reach(source, 0, source);
+	frontier.push(source, 0);
+	while (!frontier.empty()) {
+		const auto current = frontier.top();
+		frontier.pop();
+		workspace.settle(current);
+		order.push_back(current);
+		const auto cost = workspace.distance(current);
+		for (auto i = adjacency.offsets[current];
+			 i < adjacency.offsets[current + 1];
+			 ++i) {
+			const auto [node, length] = adjacency.edges[i];
+			if (workspace.settled(node))
+				continue;
+			if (!workspace.reached(node)) {
+				workspace.reach(node, cost + length, current);
+				frontier.push(node, cost + length);
+			} else if (cost + length < workspace.distance(node)) {
+				workspace.reach(node, cost + length, current);
+				frontier.decrease(node, cost + length);
+			}
+		}
+	}
+}
+
+inline void Landmarks::add(
+	std::size_t landmark,
+	const Adjacency& forward,
+	const Adjacency& backward,
+	SearchWorkspace<double>& workspace)
+{
+	const auto column = m_landmarks.size();
+	m_landmarks.push_back(landmark);
+	std::vector<std::size_t> order{};
+	search(forward, landmark, workspace, order);
+	for (const auto node : order)
+		m_from[node * m_capacity + column] = workspace.distance(node);
+	search(backward, landmark, workspace, order);
+	for (const auto node : order)
+		m_to[node * m_capacity + column] = workspace.distance(node);
+}
+
+inline std::size_t
+Landmarks::farthest(const std::vector<double>& closeness) const
+{
+	// unreachable vertices only when nothing reachable is left, a landmark
+	// there does not help queries inside the already covered part
+	std::size_t out = m_vertices;
+	std::size_t unreachable = m_vertices;
+	for (std::size_t i = 0; i < m_vertices; ++i) {
+		if (closeness[i] == INF) {
+			if (unreachable == m_vertices
+				&& std::find(m_landmarks.begin(), m_landmarks.end(), i)
+					== m_landmarks.end())
+				unreachable = i;
+		} else if (closeness[i] > 0
+			&& (out == m_vertices || closeness[i] > closeness[out])) {
+			out = i;
+		}
+	}
+	return out != m_vertices ? out : unreachable;
+}
+
+inline std::size_t Landmarks::avoid(
+	const std::vector<double>& closeness,
+	const Adjacency& forward,
+	SearchWorkspace<double>& workspace) const
+{
+	// shortest path tree from a vertex far from the landmarks, the weight of
+	// a vertex is the error of its current bound, subtrees with a landmark
+	// do not count
+	const auto root = farthest(closeness);
+	if (root == m_vertices)
+		return root;
+	std::vector<std::size_t> order{};
+	search(forward, root, workspace, order);
+	std::vector<double> size(m_vertices, 0);
+	std::vector<char> covered(m_vertices, 0);
+	std::vector<std::size_t> best_child(m_vertices, m_vertices);
+	for (const auto landmark : m_landmarks)
+		covered[landmark] = 1;
+	std::size_t best = m_vertices;
+	for (auto it = order.rbegin(); it != order.rend(); ++it) {
+		const auto node = *it;
+		if (covered[node])
+			size[node] = 0;
+		else
+			size[node]
+				+= workspace.distance(node) - lowerBound(root, node);
+		if (size[node] > 0 && (best == m_vertices || size[node] > size[best]))
+			best = node;
+		const auto parent = workspace.previous(node);
+		if (parent == node)
+			continue;
+		if (covered[node])
+			covered[parent] = 1;
+		size[parent] += size[node];
+		if (best_child[parent] == m_vertices
+			|| size[node] > size[best_child[parent]])
+			best_child[parent] = node;
+	}
+	if (best == m_vertices)
+		return farthest(closeness);
+	// a leaf of the heaviest subtree
+	while (best_child[best] != m_vertices)
+		best = best_child[best];
+	return best;
+}
+
+#endif /* LANDMARKS_HPP */
@@ -0,0 +1,101 @@
+#ifndef LAZYHEAP_HPP
+#define LAZYHEAP_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <vector>
+
+// binary heap without a position map, decrease() inserts another copy of the
+// id and the outdated ones are popped later (the caller skips settled ids)
+// same interface as IndexedHeap, the frontier can grow up to O(E)
+template <typename Key>
+class LazyHeap {
+public:
+	LazyHeap() = default;
+	LazyHeap(const LazyHeap&) = default;
+	LazyHeap(LazyHeap&&) = default;
+	LazyHeap& operator=(const LazyHeap&) = default;
+	LazyHeap& operator=(LazyHeap&&) = default;
+	~LazyHeap() = default;
+
+	void clear(std::size_t);
+	bool empty() const;
+	std::size_t size() const;
+	bool contains(std::size_t) const;
+
+	std::size_t top() const;
+	Key topKey() const;
+
+	void push(std::size_t, Key);
+	void decrease(std::size_t, Key);
+	void pop();
+
+private:
+	// std::push_heap/pop_heap instead of std::priority_queue to keep the
+	// capacity on clear()
+	std::vector<std::pair<Key, std::size_t>> m_heap{};
+};
+
+////////////////////////////////////////
+// LazyHeap implementation
+////////////////////////////////////////
+
+template <typename Key>
+void LazyHeap<Key>::clear(std::size_t)
+{
+	m_heap.clear();
+}
+
+template <typename Key>
+bool LazyHeap<Key>::empty() const
+{
+	return m_heap.empty();
+}
+
+template <typename Key>
+std::size_t LazyHeap<Key>::size() const
+{
+	return m_heap.size();
+}
+
+template <typename Key>
+bool LazyHeap<Key>::contains(std::size_t) const
+{
+	return false;
+}
+
+template <typename Key>
+std::size_t LazyHeap<Key>::top() const
+{
+	return m_heap.front().second;
+}
+
+template <typename Key>
+Key LazyHeap<Key>::topKey() const
+{
+	return m_heap.front().first;
+}
+
+template <typename Key>
+void LazyHeap<Key>::push(std::size_t id, Key key)
+{
+	m_heap.emplace_back(key, id);
+	std::push_heap(m_heap.begin(), m_heap.end(), std::greater<>{});
+}
+
+template <typename Key>
+void LazyHeap<Key>::decrease(std::size_t id, Key key)
+{
+	push(id, key);
+}
+
+template <typename Key>
+void LazyHeap<Key>::pop()
+{
+	std::pop_heap(m_heap.begin(), m_heap.end(), std::greater<>{});
+	m_heap.pop_back();
+}
+
+#endif /* LAZYHEAP_HPP */
@@ -0,0 +1,270 @@
+#ifndef PATHCACHE_HPP
+#define PATHCACHE_HPP
+
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "Graph.hpp"
+
+// cache of shortest path results in front of Graph::dijkstra/a_star, the
+// profile tells apart queries with different edge length functions and is
+// chosen by the caller
+// entries are dropped as soon as Graph::version() changes, so lengths have
+// to be changed with Graph::setEdgeLabel (writes through the non-const
+// edgeLabel are not noticed and leave stale results), when the cache is full
+// the CLOCK policy evicts entries not used since the last sweep
+// not thread safe
+template <typename V, typename E>
+class PathCache {
+public:
+	using Result = std::pair<double, std::vector<std::size_t>>;
+
+	// limit of the memory used by entries, in bytes
+	PathCache(const Graph<V, E>&, std::size_t);
+	PathCache(const PathCache&) = delete;
+	PathCache(PathCache&&) = delete;
+	PathCache& operator=(const PathCache&) = delete;
+	PathCache& operator=(PathCache&&) = delete;
+	~PathCache() = default;
+
+	// same results (and exceptions) as the Graph methods
+	template <typename F>
+	Result dijkstra(std::size_t, std::size_t, F, std::uint32_t = 0);
+	template <typename F, typename H>
+	Result a_star(std::size_t, std::size_t, F, H, std::uint32_t = 0);
+
+	std::size_t hits() const;
+	std::size_t misses() const;
+	std::size_t entries() const;
+	std::size_t bytes() const;
+	void clear();
+
+private:
+	struct Key {
+		std::uint32_t start;
+		std::uint32_t end;
+		std::uint32_t profile;
+
+		bool operator==(const Key&) const;
+	};
+
+	struct KeyHash {
+		std::size_t operator()(const Key&) const;
+	};
+
+	struct Entry {
+		Key key;
+		// infinity - no path
+		double length;
+		std::vector<std::uint32_t> path;
+		bool referenced;
+	};
+
+	template <typename Search>
+	Result lookup(std::size_t, std::size_t, std::uint32_t, Search);
+	static std::size_t cost(const Entry&);
+	void insert(Entry&&);
+	void evict(std::size_t);
+
+	const Graph<V, E>& m_graph;
+	std::size_t m_limit;
+	std::uint64_t m_version;
+	std::unordered_map<Key, std::size_t, KeyHash> m_index{};
+	// CLOCK ring, free slots are empty and listed in m_free
+	std::vector<Entry> m_slots{};
+	std::vector<std::size_t> m_free{};
+	std::size_t m_hand{0};
+	std::size_t m_bytes{0};
+	std::size_t m_hits{0};
+	std::size_t m_misses{0};
+};
+
+////////////////////////////////////////
+// PathCache implementation
+////////////////////////////////////////
+
+template <typename V, typename E>
+PathCache<V, E>::PathCache(const Graph<V, E>& graph, std::size_t limit)
+	: m_graph{graph}, m_limit{limit}, m_version{graph.version()}
+{
+}
+
+template <typename V, typename E>
+template <typename F>
+typename PathCache<V, E>::Result PathCache<V, E>::dijkstra(
+	std::size_t start,
+	std::size_t end,
+	F f,
+	std::uint32_t profile)
+{
+	return lookup(start, end, profile, [&]() {
+		return m_graph.dijkstra(start, end, f);
+	});
+}
+
+template <typename V, typename E>
+template <typename F, typename H>
+typename PathCache<V, E>::Result PathCache<V, E>::a_star(
+	std::size_t start,
+	std::size_t end,
+	F f,
+	H h,
+	std::uint32_t profile)
+{
+	return lookup(start, end, profile, [&]() {
+		return m_graph.a_star(start, end, f, h);
+	});
+}
+
+template <typename V, typename E>
+std::size_t PathCache<V, E>::hits() const
+{
+	return m_hits;
+}
+
+template <typename V, typename E>
+std::size_t PathCache<V, E>::misses() const
+{
+	return m_misses;
+}
+
+template <typename V, typename E>
+std::size_t PathCache<V, E>::entries() const
+{
+	return m_index.size();
+}
+
+template <typename V, typename E>
+std::size_t PathCache<V, E>::bytes() const
+{
+	return m_bytes;
+}
+
+template <typename V, typename E>
+void PathCache<V, E>::clear()
+{
+	m_index.clear();
+	m_slots.clear();
+	m_free.clear();
+	m_hand = 0;
+	m_bytes = 0;
+}
+
+template <typename V, typename E>
+template <typename Search>
+typename PathCache<V, E>::Result PathCache<V, E>::lookup(
+	std::size_t start,
+	std::size_t end,
+	std::uint32_t profile,
+	Search search)
+{
+	if (m_graph.version() != m_version) {
+		clear();
+		m_version = m_graph.version();
+	}
+	const Key key{
+		static_cast<std::uint32_t>(start),
+		static_cast<std::uint32_t>(end),
+		profile};
+	const auto found = m_index.find(key);
+	if (found != m_index.end()) {
+		++m_hits;
+		auto& entry = m_slots[found->second];
+		entry.referenced = true;
+		if (entry.length == std::numeric_limits<double>::infinity())
+			throw std::runtime_error{"No valid path"};
+		return Result{
+			entry.length,
+			std::vector<std::size_t>(entry.path.begin(), entry.path.end())};
+	}
+
+	++m_misses;
+	Entry entry{key, std::numeric_limits<double>::infinity(), {}, false};
+	try {
+		auto result = search();
+		entry.length = result.first;
+		entry.path.assign(result.second.begin(), result.second.end());
+		insert(std::move(entry));
+		return result;
+	} catch (const std::runtime_error&) {
+		// a missing path is cached too
+		insert(std::move(entry));
+		throw;
+	}
+}
+
+template <typename V, typename E>
+std::size_t PathCache<V, E>::cost(const Entry& entry)
+{
+	// the entry, its index node and the path
+	return sizeof(Entry) + sizeof(Key) + 2 * sizeof(std::size_t)
+		+ entry.path.capacity() * sizeof(std::uint32_t);
+}
+
+template <typename V, typename E>
+void PathCache<V, E>::insert(Entry&& entry)
+{
+	entry.path.shrink_to_fit();
+	const auto size = cost(entry);
+	if (size > m_limit)
+		return;
+	// sweep until the entry fits, referenced entries get a second chance
+	while (m_bytes + size > m_limit) {
+		if (m_hand >= m_slots.size())
+			m_hand = 0;
+		auto& victim = m_slots[m_hand];
+		// free slots are skipped
+		const auto live = m_index.find(victim.key);
+		if (live != m_index.end() && live->second == m_hand) {
+			if (victim.referenced)
+				victim.referenced = false;
+			else
+				evict(m_hand);
+		}
+		++m_hand;
+	}
+
+	std::size_t slot{m_slots.size()};
+	if (!m_free.empty()) {
+		slot = m_free.back();
+		m_free.pop_back();
+		m_slots[slot] = std::move(entry);
+	} else {
+		m_slots.push_back(std::move(entry));
+	}
+	m_index[m_slots[slot].key] = slot;
+	m_bytes += size;
+}
+
+template <typename V, typename E>
+void PathCache<V, E>::evict(std::size_t slot)
+{
+	auto& entry = m_slots[slot];
+	m_bytes -= cost(entry);
+	m_index.erase(entry.key);
+	entry.path = std::vector<std::uint32_t>{};
+	m_free.push_back(slot);
+}
+
+template <typename V, typename E>
+bool PathCache<V, E>::Key::operator==(const Key& other) const
+{
+	return start == other.start && end == other.end
+		&& profile == other.profile;
+}
+
+template <typename V, typename E>
+std::size_t PathCache<V, E>::KeyHash::operator()(const Key& key) const
+{
+	const std::uint64_t pair
+		= (static_cast<std::uint64_t>(key.start) << 32) | key.end;
+	const std::uint64_t profile = key.profile;
+	return std::hash<std::uint64_t>{}(pair ^ (profile * 0x9e3779b97f4a7c15));
+}
+
+#endif /* PATHCACHE_HPP */
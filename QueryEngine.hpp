@@ -0,0 +1,137 @@
+#ifndef QUERYENGINE_HPP
+#define QUERYENGINE_HPP
+
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "Graph.hpp"
+#include "SearchWorkspace.hpp"
+#include "ThreadPool.hpp"
+
+// answers batches of independent point-to-point queries on a graph which is
+// not modified while the engine exists, every worker thread keeps its own
+// search workspaces between batches, so queries do not allocate per vertex
+// results come back in the order of the queries, a missing path has infinite
+// length and no vertices, other exceptions of a search are rethrown
+template <typename V, typename E>
+class QueryEngine {
+public:
+	using Query = std::pair<std::size_t, std::size_t>;
+	using Result = std::pair<double, std::vector<std::size_t>>;
+
+	// 0 - one worker per hardware thread
+	explicit QueryEngine(const Graph<V, E>&, std::size_t = 0);
+	QueryEngine(const QueryEngine&) = delete;
+	QueryEngine(QueryEngine&&) = delete;
+	QueryEngine& operator=(const QueryEngine&) = delete;
+	QueryEngine& operator=(QueryEngine&&) = delete;
+	~QueryEngine() = default;
+
+	std::size_t nrOfWorkers() const;
+
+	template <typename F>
+	std::vector<Result> dijkstra(const std::vector<Query>&, F);
+	// the heuristic has the signature used by Graph::a_star
+	template <typename F, typename H>
+	std::vector<Result> a_star(const std::vector<Query>&, F, H);
+
+private:
+	// the workspaces Graph::dijkstra selects for both kinds of lengths
+	using FloatingWorkspace = SearchWorkspaceFor<double>;
+	using IntegralWorkspace = SearchWorkspaceFor<std::uint64_t>;
+
+	// runs search(workspace, start, end) for every query
+	template <typename Workspace, typename Search>
+	std::vector<Result> run(
+		const std::vector<Query>&,
+		std::vector<Workspace>&,
+		Search);
+
+	const Graph<V, E>& m_graph;
+	ThreadPool m_pool;
+	std::vector<FloatingWorkspace> m_workspaces;
+	std::vector<IntegralWorkspace> m_integral_workspaces;
+};
+
+////////////////////////////////////////
+// QueryEngine implementation
+////////////////////////////////////////
+
+template <typename V, typename E>
+QueryEngine<V, E>::QueryEngine(const Graph<V, E>& graph, std::size_t threads)
+	: m_graph{graph}
+	, m_pool{threads}
+	, m_workspaces(m_pool.size())
+	, m_integral_workspaces(m_pool.size())
+{
+}
+
+template <typename V, typename E>
+std::size_t QueryEngine<V, E>::nrOfWorkers() const
+{
+	return m_pool.size();
+}
+
+template <typename V, typename E>
+template <typename F>
+std::vector<typename QueryEngine<V, E>::Result>
+QueryEngine<V, E>::dijkstra(const std::vector<Query>& queries, F f)
+{
+	const auto search = [this, &f](auto& workspace, auto start, auto end) {
+		return m_graph.dijkstra(start, end, f, workspace);
+	};
+	using Workspace = SearchWorkspaceFor<EdgeLength<F, E>>;
+	if constexpr (std::is_same_v<Workspace, IntegralWorkspace>) {
+		return run(queries, m_integral_workspaces, search);
+	} else {
+		static_assert(std::is_same_v<Workspace, FloatingWorkspace>);
+		return run(queries, m_workspaces, search);
+	}
+}
+
+template <typename V, typename E>
+template <typename F, typename H>
+std::vector<typename QueryEngine<V, E>::Result>
+QueryEngine<V, E>::a_star(const std::vector<Query>& queries, F f, H h)
+{
+	// converted once per batch instead of once per query
+	const std::function<double(const E&)> length = f;
+	const std::function<double(
+		const Graph<V, E>&, const std::size_t, const std::size_t)>
+		heuristic = h;
+	return run(
+		queries,
+		m_workspaces,
+		[this, &length, &heuristic](auto& workspace, auto start, auto end) {
+			return m_graph.a_star(start, end, length, heuristic, workspace);
+		});
+}
+
+template <typename V, typename E>
+template <typename Workspace, typename Search>
+std::vector<typename QueryEngine<V, E>::Result> QueryEngine<V, E>::run(
+	const std::vector<Query>& queries,
+	std::vector<Workspace>& workspaces,
+	Search search)
+{
+	std::vector<Result> out(queries.size());
+	m_pool.parallelFor(queries.size(), [&](std::size_t worker, std::size_t i) {
+		try {
+			out[i] = search(
+				workspaces[worker], queries[i].first, queries[i].second);
+		} catch (const std::runtime_error& error) {
+			if (std::string_view{error.what()} != "No valid path")
+				throw;
+			out[i] = Result{std::numeric_limits<double>::infinity(), {}};
+		}
+	});
+	return out;
+}
+
+#endif /* QUERYENGINE_HPP */
@@ -0,0 +1,154 @@
+#ifndef RADIXHEAP_HPP
+#define RADIXHEAP_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// monotone priority queue for unsigned integer keys, a pushed key must not be
+// smaller than the last minimum returned by top() or topKey() (always true in
+// Dijkstra with non-negative weights)
+// an element lives in the bucket given by the highest bit in which its key
+// differs from the last minimum, so it moves at most once per bit
+// same interface as IndexedHeap, decrease() inserts another copy like LazyHeap
+template <typename Key>
+class RadixHeap {
+	static_assert(std::is_unsigned_v<Key>, "radix heap keys must be unsigned");
+
+public:
+	RadixHeap() = default;
+	RadixHeap(const RadixHeap&) = default;
+	RadixHeap(RadixHeap&&) = default;
+	RadixHeap& operator=(const RadixHeap&) = default;
+	RadixHeap& operator=(RadixHeap&&) = default;
+	~RadixHeap() = default;
+
+	void clear(std::size_t);
+	bool empty() const;
+	std::size_t size() const;
+	bool contains(std::size_t) const;
+
+	std::size_t top() const;
+	Key topKey() const;
+
+	void push(std::size_t, Key);
+	void decrease(std::size_t, Key);
+	void pop();
+
+private:
+	static constexpr std::size_t BITS = std::numeric_limits<Key>::digits;
+
+	std::size_t bucket(Key) const;
+	// moves the minimum to bucket 0 if it is empty, done lazily when the
+	// minimum is needed because it raises the lower bound for pushed keys
+	void refill() const;
+
+	mutable std::array<std::vector<std::pair<Key, std::size_t>>, BITS + 1>
+		m_buckets{};
+	mutable Key m_last{0};
+	std::size_t m_size{0};
+};
+
+////////////////////////////////////////
+// RadixHeap implementation
+////////////////////////////////////////
+
+template <typename Key>
+void RadixHeap<Key>::clear(std::size_t)
+{
+	for (auto& b : m_buckets)
+		b.clear();
+	m_last = 0;
+	m_size = 0;
+}
+
+template <typename Key>
+bool RadixHeap<Key>::empty() const
+{
+	return m_size == 0;
+}
+
+template <typename Key>
+std::size_t RadixHeap<Key>::size() const
+{
+	return m_size;
+}
+
+template <typename Key>
+bool RadixHeap<Key>::contains(std::size_t) const
+{
+	return false;
+}
+
+template <typename Key>
+std::size_t RadixHeap<Key>::top() const
+{
+	refill();
+	return m_buckets[0].back().second;
+}
+
+template <typename Key>
+Key RadixHeap<Key>::topKey() const
+{
+	refill();
+	return m_buckets[0].back().first;
+}
+
+template <typename Key>
+void RadixHeap<Key>::push(std::size_t id, Key key)
+{
+	m_buckets[bucket(key)].emplace_back(key, id);
+	++m_size;
+}
+
+template <typename Key>
+void RadixHeap<Key>::decrease(std::size_t id, Key key)
+{
+	push(id, key);
+}
+
+template <typename Key>
+void RadixHeap<Key>::pop()
+{
+	refill();
+	m_buckets[0].pop_back();
+	--m_size;
+}
+
+template <typename Key>
+std::size_t RadixHeap<Key>::bucket(Key key) const
+{
+	const auto diff = static_cast<std::uint64_t>(key ^ m_last);
+	if (diff == 0)
+		return 0;
+#if defined(__GNUC__)
+	return 64 - static_cast<std::size_t>(__builtin_clzll(diff));
+#else
+	std::size_t bits = 0;
+	for (auto tmp = diff; tmp; tmp >>= 1)
+		++bits;
+	return bits;
+#endif
+}
+
+template <typename Key>
+void RadixHeap<Key>::refill() const
+{
+	if (!m_buckets[0].empty())
+		return;
+	std::size_t i = 1;
+	while (m_buckets[i].empty())
+		++i;
+	auto& source = m_buckets[i];
+	m_last = std::min_element(source.begin(), source.end())->first;
+	// every element lands in a lower bucket
+	for (const auto& elem : source)
+		m_buckets[bucket(elem.first)].push_back(elem);
+	source.clear();
+}
+
+#endif /* RADIXHEAP_HPP */
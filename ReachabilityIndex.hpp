@@ -0,0 +1,290 @@
+#ifndef GRAPH_HPP
+#error Include Graph.hpp!
+#endif
+#ifndef REACHABILITYINDEX_HPP
+#define REACHABILITYINDEX_HPP
+
+#include "Graph.hpp"
+
+// answers "is there a path from u to v" queries
+// up to MATRIX_LIMIT vertices (or the limit given to build) the transitive
+// closure is stored as a bit matrix (word-parallel Warshall, O(1) queries,
+// cheap edge insertion), bigger graphs get a tree cover interval labelling of
+// the SCC condensation (O(log k) queries, k - number of intervals of the
+// source component)
+template <typename V, typename E>
+class Graph<V, E>::ReachabilityIndex {
+	friend class Graph<V, E>;
+
+public:
+	static constexpr std::size_t MATRIX_LIMIT = 16384;
+
+	ReachabilityIndex(const ReachabilityIndex&) = default;
+	ReachabilityIndex(ReachabilityIndex&&) = default;
+	ReachabilityIndex& operator=(const ReachabilityIndex&) = default;
+	ReachabilityIndex& operator=(ReachabilityIndex&&) = default;
+	~ReachabilityIndex() = default;
+
+	// every vertex reaches itself
+	bool reachable(std::size_t, std::size_t) const;
+
+private:
+	ReachabilityIndex() = default;
+
+	void build(const Graph&, std::size_t);
+	void buildMatrix(const Graph&);
+	void buildIntervals(const Graph&);
+	void buildComponents(const Graph&);
+	// updates the index for a new edge, false if it has to be rebuilt
+	bool insertEdge(std::size_t, std::size_t);
+
+	bool m_use_matrix{true};
+	// bit matrix
+	std::size_t m_words{0};
+	std::vector<std::uint64_t> m_matrix{};
+	// interval labelling
+	std::vector<std::size_t> m_component{};
+	std::vector<std::size_t> m_post{};
+	std::vector<std::size_t> m_offsets{};
+	std::vector<std::pair<std::size_t, std::size_t>> m_intervals{};
+};
+
+////////////////////////////////////////
+// ReachabilityIndex implementation
+////////////////////////////////////////
+
+template <typename V, typename E>
+bool Graph<V, E>::ReachabilityIndex::reachable(
+	std::size_t from,
+	std::size_t to) const
+{
+	if (m_use_matrix)
+		return (m_matrix[from * m_words + to / 64] >> (to % 64)) & 1u;
+
+	const auto component = m_component[from];
+	const auto post = m_post[m_component[to]];
+	const auto first = m_intervals.begin() + m_offsets[component];
+	const auto last = m_intervals.begin() + m_offsets[component + 1];
+	// first interval starting after post, the candidate is right before it
+	auto it = std::upper_bound(
+		first, last, post, [](std::size_t value, const auto& interval) {
+			return value < interval.first;
+		});
+	return it != first && (it - 1)->second >= post;
+}
+
+template <typename V, typename E>
+void Graph<V, E>::ReachabilityIndex::build(
+	const Graph& graph,
+	std::size_t matrix_limit)
+{
+	m_use_matrix = graph.nrOfVertices() <= matrix_limit;
+	if (m_use_matrix)
+		buildMatrix(graph);
+	else
+		buildIntervals(graph);
+}
+
+template <typename V, typename E>
+void Graph<V, E>::ReachabilityIndex::buildMatrix(const Graph& graph)
+{
+	const auto number_of_vertices = graph.nrOfVertices();
+	m_words = (number_of_vertices + 63) / 64;
+	m_matrix.assign(number_of_vertices * m_words, 0);
+	for (std::size_t i = 0; i < number_of_vertices; ++i) {
+		auto* row = &m_matrix[i * m_words];
+		row[i / 64] |= std::uint64_t{1} << (i % 64);
+		const auto& edges = graph.m_data[i].second;
+		for (std::size_t j = 0; j < number_of_vertices; ++j)
+			if (edges[j].has_value())
+				row[j / 64] |= std::uint64_t{1} << (j % 64);
+	}
+
+	// Warshall, every row which reaches k gets everything k reaches
+	for (std::size_t k = 0; k < number_of_vertices; ++k) {
+		const auto* row_k = &m_matrix[k * m_words];
+		const auto word = k / 64;
+		const auto bit = std::uint64_t{1} << (k % 64);
+		for (std::size_t i = 0; i < number_of_vertices; ++i) {
+			if (i == k)
+				continue;
+			auto* row_i = &m_matrix[i * m_words];
+			if (!(row_i[word] & bit))
+				continue;
+			for (std::size_t w = 0; w < m_words; ++w)
+				row_i[w] |= row_k[w];
+		}
+	}
+}
+
+template <typename V, typename E>
+void Graph<V, E>::ReachabilityIndex::buildComponents(const Graph& graph)
+{
+	// iterative Tarjan, components are numbered in reverse topological order
+	constexpr auto none = std::numeric_limits<std::size_t>::max();
+	const auto number_of_vertices = graph.nrOfVertices();
+	std::vector<std::size_t> index(number_of_vertices, none);
+	std::vector<std::size_t> low(number_of_vertices);
+	std::vector<bool> on_stack(number_of_vertices);
+	std::vector<std::size_t> stack{};
+	std::vector<std::pair<std::size_t, std::size_t>> calls{};
+	std::size_t counter{0};
+	std::size_t components{0};
+
+	m_component.assign(number_of_vertices, none);
+	for (std::size_t root = 0; root < number_of_vertices; ++root) {
+		if (index[root] != none)
+			continue;
+		index[root] = low[root] = counter++;
+		stack.push_back(root);
+		on_stack[root] = true;
+		calls.emplace_back(root, 0);
+		while (!calls.empty()) {
+			auto& [current, next] = calls.back();
+			const auto& row = graph.m_data[current].second;
+			bool descended = false;
+			for (; next < number_of_vertices; ++next) {
+				if (!row[next].has_value())
+					continue;
+				const auto i = next;
+				if (index[i] == none) {
+					++next;
+					index[i] = low[i] = counter++;
+					stack.push_back(i);
+					on_stack[i] = true;
+					// invalidates current and next
+					calls.emplace_back(i, 0);
+					descended = true;
+					break;
+				}
+				if (on_stack[i])
+					low[current] = std::min(low[current], index[i]);
+			}
+			if (descended)
+				continue;
+
+			const auto finished = current;
+			if (low[finished] == index[finished]) {
+				std::size_t i;
+				do {
+					i = stack.back();
+					stack.pop_back();
+					on_stack[i] = false;
+					m_component[i] = components;
+				} while (i != finished);
+				++components;
+			}
+			calls.pop_back();
+			if (!calls.empty()) {
+				auto& parent = calls.back().first;
+				low[parent] = std::min(low[parent], low[finished]);
+			}
+		}
+	}
+}
+
+template <typename V, typename E>
+void Graph<V, E>::ReachabilityIndex::buildIntervals(const Graph& graph)
+{
+	buildComponents(graph);
+	const auto number_of_vertices = graph.nrOfVertices();
+	const auto components = number_of_vertices == 0
+		? std::size_t{0}
+		: *std::max_element(m_component.begin(), m_component.end()) + 1;
+
+	// condensation
+	std::vector<std::vector<std::size_t>> successors(components);
+	std::vector<bool> has_predecessor(components);
+	for (std::size_t i = 0; i < number_of_vertices; ++i) {
+		const auto& row = graph.m_data[i].second;
+		for (std::size_t j = 0; j < number_of_vertices; ++j) {
+			if (!row[j].has_value() || m_component[i] == m_component[j])
+				continue;
+			successors[m_component[i]].push_back(m_component[j]);
+			has_predecessor[m_component[j]] = true;
+		}
+	}
+	for (auto& list : successors) {
+		std::sort(list.begin(), list.end());
+		list.erase(std::unique(list.begin(), list.end()), list.end());
+	}
+
+	// spanning forest, the subtree of c covers post numbers [low[c], post[c]]
+	std::vector<std::size_t> low(components);
+	std::vector<bool> visited(components);
+	std::vector<std::pair<std::size_t, std::size_t>> calls{};
+	std::size_t counter{0};
+	m_post.assign(components, 0);
+	for (std::size_t root = 0; root < components; ++root) {
+		if (has_predecessor[root])
+			continue;
+		visited[root] = true;
+		low[root] = counter;
+		calls.emplace_back(root, 0);
+		while (!calls.empty()) {
+			auto& [current, next] = calls.back();
+			if (next < successors[current].size()) {
+				const auto i = successors[current][next++];
+				if (visited[i])
+					continue;
+				visited[i] = true;
+				low[i] = counter;
+				calls.emplace_back(i, 0);
+				continue;
+			}
+			m_post[current] = counter++;
+			calls.pop_back();
+		}
+	}
+
+	// successors have smaller ids, so their labels are already complete
+	std::vector<std::pair<std::size_t, std::size_t>> buffer{};
+	m_offsets.assign(1, 0);
+	m_intervals.clear();
+	for (std::size_t c = 0; c < components; ++c) {
+		buffer.clear();
+		buffer.emplace_back(low[c], m_post[c]);
+		for (auto d : successors[c])
+			buffer.insert(
+				buffer.end(),
+				m_intervals.begin() + m_offsets[d],
+				m_intervals.begin() + m_offsets[d + 1]);
+		std::sort(buffer.begin(), buffer.end());
+		for (const auto& interval : buffer) {
+			if (m_intervals.size() > m_offsets[c]
+				&& interval.first <= m_intervals.back().second + 1)
+				m_intervals.back().second
+					= std::max(m_intervals.back().second, interval.second);
+			else
+				m_intervals.push_back(interval);
+		}
+		m_offsets.push_back(m_intervals.size());
+	}
+}
+
+template <typename V, typename E>
+bool Graph<V, E>::ReachabilityIndex::insertEdge(
+	std::size_t from,
+	std::size_t to)
+{
+	if (!m_use_matrix)
+		return false;
+	if (reachable(from, to))
+		return true;
+
+	// everything reaching the source now reaches what the target reaches
+	const auto number_of_vertices = m_matrix.size() / m_words;
+	const auto* row_to = &m_matrix[to * m_words];
+	const auto word = from / 64;
+	const auto bit = std::uint64_t{1} << (from % 64);
+	for (std::size_t i = 0; i < number_of_vertices; ++i) {
+		auto* row_i = &m_matrix[i * m_words];
+		if (!(row_i[word] & bit) || i == to)
+			continue;
+		for (std::size_t w = 0; w < m_words; ++w)
+			row_i[w] |= row_to[w];
+	}
+	return true;
+}
+
+#endif /* REACHABILITYINDEX_HPP */
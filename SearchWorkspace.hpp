@@ -0,0 +1,146 @@
+#ifndef SEARCHWORKSPACE_HPP
+#define SEARCHWORKSPACE_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+#include "IndexedHeap.hpp"
+#include "RadixHeap.hpp"
+
+// per-vertex state of a shortest path search (distance, predecessor, settled
+// flag) in flat arrays indexed by vertex id, together with the frontier heap
+// the arrays are reused between searches, reset() is O(1) because the state
+// of a vertex only counts if it was written during the current search
+template <typename Cost = double, typename Heap = IndexedHeap<Cost>>
+class SearchWorkspace {
+public:
+	SearchWorkspace() = default;
+	SearchWorkspace(const SearchWorkspace&) = default;
+	SearchWorkspace(SearchWorkspace&&) = default;
+	SearchWorkspace& operator=(const SearchWorkspace&) = default;
+	SearchWorkspace& operator=(SearchWorkspace&&) = default;
+	~SearchWorkspace() = default;
+
+	// starts a new search on a graph with the given number of vertices
+	void reset(std::size_t);
+
+	Heap& heap();
+
+	bool reached(std::size_t) const;
+	bool settled(std::size_t) const;
+	// valid only for reached vertices
+	Cost distance(std::size_t) const;
+	std::size_t previous(std::size_t) const;
+
+	void reach(std::size_t, Cost, std::size_t);
+	void settle(std::size_t);
+
+	// vertices from the start of the search (its own predecessor) to the
+	// given one
+	std::vector<std::size_t> path(std::size_t) const;
+
+private:
+	Heap m_heap{};
+	std::vector<Cost> m_distance{};
+	std::vector<std::size_t> m_previous{};
+	// m_generation - reached, m_generation + 1 - settled, less - untouched
+	std::vector<std::uint32_t> m_state{};
+	std::uint32_t m_generation{0};
+};
+
+// type of the lengths returned by an edge length function, a functor
+// returning const int& gives int
+template <typename F, typename E>
+using EdgeLength = std::decay_t<std::invoke_result_t<F&, const E&>>;
+
+// workspace matching the type returned by an edge length function, integral
+// lengths are summed as 64 bit integers and use a radix heap
+template <typename Length>
+using SearchWorkspaceFor = std::conditional_t<
+	std::is_integral_v<std::decay_t<Length>>,
+	SearchWorkspace<std::uint64_t, RadixHeap<std::uint64_t>>,
+	SearchWorkspace<double>>;
+
+////////////////////////////////////////
+// SearchWorkspace implementation
+////////////////////////////////////////
+
+template <typename Cost, typename Heap>
+void SearchWorkspace<Cost, Heap>::reset(std::size_t number_of_vertices)
+{
+	if (m_state.size() < number_of_vertices) {
+		m_distance.resize(number_of_vertices);
+		m_previous.resize(number_of_vertices);
+		m_state.resize(number_of_vertices, 0);
+	}
+	m_heap.clear(number_of_vertices);
+	m_generation += 2;
+	// on overflow old states could look current again
+	if (m_generation >= std::numeric_limits<std::uint32_t>::max() - 1) {
+		std::fill(m_state.begin(), m_state.end(), 0);
+		m_generation = 2;
+	}
+}
+
+template <typename Cost, typename Heap>
+Heap& SearchWorkspace<Cost, Heap>::heap()
+{
+	return m_heap;
+}
+
+template <typename Cost, typename Heap>
+bool SearchWorkspace<Cost, Heap>::reached(std::size_t node) const
+{
+	return m_state[node] >= m_generation;
+}
+
+template <typename Cost, typename Heap>
+bool SearchWorkspace<Cost, Heap>::settled(std::size_t node) const
+{
+	return m_state[node] == m_generation + 1;
+}
+
+template <typename Cost, typename Heap>
+Cost SearchWorkspace<Cost, Heap>::distance(std::size_t node) const
+{
+	return m_distance[node];
+}
+
+template <typename Cost, typename Heap>
+std::size_t SearchWorkspace<Cost, Heap>::previous(std::size_t node) const
+{
+	return m_previous[node];
+}
+
+template <typename Cost, typename Heap>
+void SearchWorkspace<Cost, Heap>::reach(
+	std::size_t node,
+	Cost distance,
+	std::size_t previous)
+{
+	m_distance[node] = distance;
+	m_previous[node] = previous;
+	m_state[node] = m_generation;
+}
+
+template <typename Cost, typename Heap>
+void SearchWorkspace<Cost, Heap>::settle(std::size_t node)
+{
+	m_state[node] = m_generation + 1;
+}
+
+template <typename Cost, typename Heap>
+std::vector<std::size_t>
+SearchWorkspace<Cost, Heap>::path(std::size_t end) const
+{
+	std::vector<std::size_t> out{end};
+	for (auto node = end; m_previous[node] != node; node = m_previous[node])
+		out.push_back(m_previous[node]);
+	std::reverse(out.begin(), out.end());
+	return out;
+}
+
+#endif /* SEARCHWORKSPACE_HPP */
@@ -0,0 +1,153 @@
+#ifndef THREADPOOL_HPP
+#define THREADPOOL_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// fixed set of worker threads running parallelFor loops
+class ThreadPool {
+public:
+	// 0 - one worker per hardware thread
+	explicit ThreadPool(std::size_t = 0);
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool(ThreadPool&&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+	ThreadPool& operator=(ThreadPool&&) = delete;
+	~ThreadPool();
+
+	std::size_t size() const;
+	// the number of workers a pool would start for the argument
+	static std::size_t threadCount(std::size_t);
+
+	// calls body(worker, index) for every index in [0, count) and waits for
+	// all of them, worker is in [0, size()), the first exception is rethrown
+	template <typename F>
+	void parallelFor(std::size_t, F&&);
+
+private:
+	void run(std::size_t);
+	void work(std::size_t);
+
+	std::vector<std::thread> m_threads{};
+	// serializes parallelFor calls from different threads
+	std::mutex m_loop{};
+	std::mutex m_mutex{};
+	std::condition_variable m_wake{};
+	std::condition_variable m_done{};
+	// current loop, the body is called once per chunk of indices
+	std::function<void(std::size_t, std::size_t, std::size_t)> m_task{};
+	std::size_t m_count{0};
+	std::size_t m_chunk{1};
+	std::atomic<std::size_t> m_next{0};
+	std::size_t m_generation{0};
+	std::size_t m_busy{0};
+	std::exception_ptr m_error{};
+	bool m_stop{false};
+};
+
+////////////////////////////////////////
+// ThreadPool implementation
+////////////////////////////////////////
+
+inline ThreadPool::ThreadPool(std::size_t threads)
+{
+	threads = threadCount(threads);
+	m_threads.reserve(threads);
+	for (std::size_t i = 0; i < threads; ++i)
+		m_threads.emplace_back(&ThreadPool::run, this, i);
+}
+
+inline ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock{m_mutex};
+		m_stop = true;
+	}
+	m_wake.notify_all();
+	for (auto& thread : m_threads)
+		thread.join();
+}
+
+inline std::size_t ThreadPool::size() const
+{
+	return m_threads.size();
+}
+
+inline std::size_t ThreadPool::threadCount(std::size_t threads)
+{
+	if (threads != 0)
+		return threads;
+	return std::max(1u, std::thread::hardware_concurrency());
+}
+
+template <typename F>
+void ThreadPool::parallelFor(std::size_t count, F&& body)
+{
+	if (count == 0)
+		return;
+	std::lock_guard<std::mutex> loop{m_loop};
+	std::unique_lock<std::mutex> lock{m_mutex};
+	m_task = [&body](std::size_t worker, std::size_t begin, std::size_t end) {
+		for (auto i = begin; i < end; ++i)
+			body(worker, i);
+	};
+	m_count = count;
+	// a few chunks per worker keeps them balanced without contention
+	m_chunk = std::max<std::size_t>(1, count / (m_threads.size() * 8));
+	m_next = 0;
+	m_error = nullptr;
+	m_busy = m_threads.size();
+	++m_generation;
+	m_wake.notify_all();
+	m_done.wait(lock, [this] { return m_busy == 0; });
+	m_task = nullptr;
+	if (m_error)
+		std::rethrow_exception(m_error);
+}
+
+inline void ThreadPool::run(std::size_t worker)
+{
+	std::size_t generation{0};
+	while (true) {
+		{
+			std::unique_lock<std::mutex> lock{m_mutex};
+			m_wake.wait(lock, [&] {
+				return m_stop || m_generation != generation;
+			});
+			if (m_stop)
+				return;
+			generation = m_generation;
+		}
+		work(worker);
+		std::lock_guard<std::mutex> lock{m_mutex};
+		if (--m_busy == 0)
+			m_done.notify_one();
+	}
+}
+
+inline void ThreadPool::work(std::size_t worker)
+{
+	try {
+		while (true) {
+			const auto begin = m_next.fetch_add(m_chunk);
+			if (begin >= m_count)
+				return;
+			m_task(worker, begin, std::min(begin + m_chunk, m_count));
+		}
+	} catch (...) {
+		std::lock_guard<std::mutex> lock{m_mutex};
+		if (!m_error)
+			m_error = std::current_exception();
+		// skip the remaining chunks
+		m_next = m_count;
+	}
+}
+
+#endif /* THREADPOOL_HPP */
@@ -0,0 +1,241 @@
+#ifndef GRAPH_HPP
+#error Include Graph.hpp!
+#endif
+#ifndef TOPOLOGICALORDER_HPP
+#define TOPOLOGICALORDER_HPP
+
+#include "Graph.hpp"
+
+// topological order kept up to date on edge insertion (Pearce-Kelly), only
+// the vertices between the endpoints of an edge inserted against the order
+// are searched and reordered
+template <typename V, typename E>
+class Graph<V, E>::TopologicalOrder {
+	friend class Graph<V, E>;
+
+public:
+	TopologicalOrder(const TopologicalOrder&) = default;
+	TopologicalOrder(TopologicalOrder&&) = default;
+	TopologicalOrder& operator=(const TopologicalOrder&) = default;
+	TopologicalOrder& operator=(TopologicalOrder&&) = default;
+	~TopologicalOrder() = default;
+
+	// vertices in topological order
+	const std::vector<std::size_t>& order() const;
+	// position of the vertex in order()
+	std::size_t position(std::size_t) const;
+
+private:
+	TopologicalOrder() = default;
+
+	// computes the order from scratch, false if the graph has a cycle
+	bool build(const Graph&);
+	// reorders for the edge about to be inserted, false if it closes a cycle
+	bool insertEdge(const Graph&, std::size_t, std::size_t);
+	void insertVertex();
+	void removeVertex(std::size_t);
+
+	bool searchForward(const Graph&, std::size_t, std::size_t);
+	void searchBackward(const Graph&, std::size_t, std::size_t);
+	void reorder();
+
+	std::vector<std::size_t> m_order{};
+	std::vector<std::size_t> m_position{};
+	// buffers of the last search, kept to avoid allocations
+	std::vector<bool> m_visited{};
+	std::vector<std::size_t> m_forward{};
+	std::vector<std::size_t> m_backward{};
+	std::vector<std::size_t> m_stack{};
+};
+
+////////////////////////////////////////
+// TopologicalOrder implementation
+////////////////////////////////////////
+
+template <typename V, typename E>
+const std::vector<std::size_t>& Graph<V, E>::TopologicalOrder::order() const
+{
+	return m_order;
+}
+
+template <typename V, typename E>
+std::size_t Graph<V, E>::TopologicalOrder::position(std::size_t node) const
+{
+	return m_position[node];
+}
+
+template <typename V, typename E>
+bool Graph<V, E>::TopologicalOrder::build(const Graph& graph)
+{
+	// Kahn's algorithm
+	const auto number_of_vertices = graph.nrOfVertices();
+	std::vector<std::size_t> in_degree(number_of_vertices);
+	for (const auto& vertex : graph.m_data)
+		for (std::size_t i = 0; i < number_of_vertices; ++i)
+			if (vertex.second[i].has_value())
+				++in_degree[i];
+
+	m_order.clear();
+	m_order.reserve(number_of_vertices);
+	for (std::size_t i = 0; i < number_of_vertices; ++i)
+		if (in_degree[i] == 0)
+			m_order.push_back(i);
+	for (std::size_t head = 0; head < m_order.size(); ++head) {
+		const auto& row = graph.m_data[m_order[head]].second;
+		for (std::size_t i = 0; i < number_of_vertices; ++i)
+			if (row[i].has_value() && --in_degree[i] == 0)
+				m_order.push_back(i);
+	}
+	if (m_order.size() != number_of_vertices)
+		return false;
+
+	m_position.resize(number_of_vertices);
+	for (std::size_t i = 0; i < number_of_vertices; ++i)
+		m_position[m_order[i]] = i;
+	m_visited.assign(number_of_vertices, false);
+	return true;
+}
+
+template <typename V, typename E>
+bool Graph<V, E>::TopologicalOrder::insertEdge(
+	const Graph& graph,
+	std::size_t from,
+	std::size_t to)
+{
+	if (from == to)
+		return false;
+	const auto lower = m_position[to];
+	const auto upper = m_position[from];
+	// already consistent with the order
+	if (lower > upper)
+		return true;
+
+	m_forward.clear();
+	m_backward.clear();
+	const bool acyclic = searchForward(graph, to, upper);
+	if (acyclic) {
+		searchBackward(graph, from, lower);
+		reorder();
+	}
+	for (auto i : m_forward)
+		m_visited[i] = false;
+	for (auto i : m_backward)
+		m_visited[i] = false;
+	return acyclic;
+}
+
+template <typename V, typename E>
+bool Graph<V, E>::TopologicalOrder::searchForward(
+	const Graph& graph,
+	std::size_t start,
+	std::size_t upper)
+{
+	const auto number_of_vertices = graph.nrOfVertices();
+	m_stack.clear();
+	m_stack.push_back(start);
+	m_visited[start] = true;
+	m_forward.push_back(start);
+	while (!m_stack.empty()) {
+		const auto current = m_stack.back();
+		m_stack.pop_back();
+		const auto& row = graph.m_data[current].second;
+		for (std::size_t i = 0; i < number_of_vertices; ++i) {
+			if (!row[i].has_value())
+				continue;
+			// reached the source of the new edge
+			if (m_position[i] == upper)
+				return false;
+			if (m_visited[i] || m_position[i] > upper)
+				continue;
+			m_visited[i] = true;
+			m_forward.push_back(i);
+			m_stack.push_back(i);
+		}
+	}
+	return true;
+}
+
+template <typename V, typename E>
+void Graph<V, E>::TopologicalOrder::searchBackward(
+	const Graph& graph,
+	std::size_t start,
+	std::size_t lower)
+{
+	const auto number_of_vertices = graph.nrOfVertices();
+	m_stack.clear();
+	m_stack.push_back(start);
+	m_visited[start] = true;
+	m_backward.push_back(start);
+	while (!m_stack.empty()) {
+		const auto current = m_stack.back();
+		m_stack.pop_back();
+		for (std::size_t i = 0; i < number_of_vertices; ++i) {
+			if (!graph.m_data[i].second[current].has_value())
+				continue;
+			if (m_visited[i] || m_position[i] < lower)
+				continue;
+			m_visited[i] = true;
+			m_backward.push_back(i);
+			m_stack.push_back(i);
+		}
+	}
+}
+
+template <typename V, typename E>
+void Graph<V, E>::TopologicalOrder::reorder()
+{
+	const auto by_position = [this](std::size_t lhs, std::size_t rhs) {
+		return m_position[lhs] < m_position[rhs];
+	};
+	std::sort(m_forward.begin(), m_forward.end(), by_position);
+	std::sort(m_backward.begin(), m_backward.end(), by_position);
+
+	// the affected vertices share the same set of positions, ancestors of the
+	// edge source go first
+	m_stack.clear();
+	for (auto i : m_backward)
+		m_stack.push_back(m_position[i]);
+	for (auto i : m_forward)
+		m_stack.push_back(m_position[i]);
+	std::sort(m_stack.begin(), m_stack.end());
+
+	std::size_t slot = 0;
+	for (const auto* part : {&m_backward, &m_forward}) {
+		for (auto i : *part) {
+			m_position[i] = m_stack[slot];
+			m_order[m_stack[slot]] = i;
+			++slot;
+		}
+	}
+}
+
+template <typename V, typename E>
+void Graph<V, E>::TopologicalOrder::insertVertex()
+{
+	m_position.push_back(m_order.size());
+	m_order.push_back(m_order.size());
+	m_visited.push_back(false);
+}
+
+template <typename V, typename E>
+void Graph<V, E>::TopologicalOrder::removeVertex(std::size_t vertex_id)
+{
+	m_order.erase(m_order.begin() + m_position[vertex_id]);
+#if USE_FASTER_REMOVAL
+	// the last vertex takes the id of the removed one
+	const auto last = m_position.size() - 1;
+	for (auto& i : m_order)
+		if (i == last)
+			i = vertex_id;
+#else
+	for (auto& i : m_order)
+		if (i > vertex_id)
+			--i;
+#endif
+	m_position.pop_back();
+	m_visited.pop_back();
+	for (std::size_t i = 0; i < m_order.size(); ++i)
+		m_position[m_order[i]] = i;
+}
+
+#endif /* TOPOLOGICALORDER_HPP */
@@ -0,0 +1,223 @@
+#ifndef WEIGHTPROFILE_HPP
+#define WEIGHTPROFILE_HPP
+
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "Graph.hpp"
+#include "SearchWorkspace.hpp"
+
+// edge lengths of a graph evaluated once: the out-edges of every vertex are
+// stored one after another (as in the adjacency matrix, by target id) with
+// their lengths in a parallel array, queries read plain doubles instead of
+// calling the length function (and the heuristic) for every edge
+// the heuristic of A* can be cached for one target at a time
+// the graph is not needed after build, the profile does not follow its
+// changes, version() tells which Graph::version() it was built from
+class WeightProfile {
+public:
+	WeightProfile() = default;
+	WeightProfile(const WeightProfile&) = default;
+	WeightProfile(WeightProfile&&) = default;
+	WeightProfile& operator=(const WeightProfile&) = default;
+	WeightProfile& operator=(WeightProfile&&) = default;
+	~WeightProfile() = default;
+
+	// a negative length throws domain_error
+	template <typename V, typename E, typename F>
+	static WeightProfile build(const Graph<V, E>&, F);
+
+	std::size_t nrOfVertices() const;
+	std::size_t nrOfEdges() const;
+	std::uint64_t version() const;
+
+	// h(graph, vertex, target) for every vertex, as called by Graph::a_star
+	template <typename V, typename E, typename H>
+	void cacheHeuristic(const Graph<V, E>&, H, std::size_t);
+	bool hasHeuristic() const;
+	// nrOfVertices() if there is no cached heuristic
+	std::size_t heuristicTarget() const;
+
+	// same results as Graph::dijkstra and Graph::a_star, a_star needs the
+	// heuristic cached for the end, otherwise it throws logic_error
+	std::pair<double, std::vector<std::size_t>>
+	dijkstra(std::size_t, std::size_t) const;
+	template <typename Heap>
+	std::pair<double, std::vector<std::size_t>> dijkstra(
+		std::size_t,
+		std::size_t,
+		SearchWorkspace<double, Heap>&) const;
+	std::pair<double, std::vector<std::size_t>>
+	a_star(std::size_t, std::size_t) const;
+	template <typename Heap>
+	std::pair<double, std::vector<std::size_t>> a_star(
+		std::size_t,
+		std::size_t,
+		SearchWorkspace<double, Heap>&) const;
+
+private:
+	// frontier keys are distance + estimate, estimates are all zero without
+	// the heuristic
+	template <bool Heuristic, typename Heap>
+	std::pair<double, std::vector<std::size_t>> search(
+		std::size_t,
+		std::size_t,
+		SearchWorkspace<double, Heap>&) const;
+
+	std::uint64_t m_version{0};
+	std::vector<std::size_t> m_offsets{0};
+	std::vector<std::uint32_t> m_targets{};
+	std::vector<double> m_weights{};
+	std::size_t m_heuristic_target{0};
+	std::vector<double> m_heuristic{};
+};
+
+////////////////////////////////////////
+// WeightProfile implementation
+////////////////////////////////////////
+
+template <typename V, typename E, typename F>
+WeightProfile WeightProfile::build(const Graph<V, E>& graph, F f)
+{
+	using Length = EdgeLength<F, E>;
+
+	const auto vertices = graph.nrOfVertices();
+	WeightProfile out{};
+	out.m_version = graph.version();
+	out.m_heuristic_target = vertices;
+	out.m_offsets.assign(vertices + 1, 0);
+	// edges come in row order, so the rows are filled one after another
+	for (auto it = graph.beginEdges(); it != graph.endEdges(); ++it) {
+		const Length length = f(*it);
+		if constexpr (std::is_signed_v<Length>)
+			if (length < 0)
+				throw std::domain_error{"Ujemna długość krawędzi"};
+		++out.m_offsets[it.v1id() + 1];
+		out.m_targets.push_back(static_cast<std::uint32_t>(it.v2id()));
+		out.m_weights.push_back(static_cast<double>(length));
+	}
+	for (std::size_t i = 0; i < vertices; ++i)
+		out.m_offsets[i + 1] += out.m_offsets[i];
+	return out;
+}
+
+inline std::size_t WeightProfile::nrOfVertices() const
+{
+	return m_offsets.size() - 1;
+}
+
+inline std::size_t WeightProfile::nrOfEdges() const
+{
+	return m_weights.size();
+}
+
+inline std::uint64_t WeightProfile::version() const
+{
+	return m_version;
+}
+
+template <typename V, typename E, typename H>
+void WeightProfile::cacheHeuristic(
+	const Graph<V, E>& graph,
+	H h,
+	std::size_t target)
+{
+	m_heuristic.resize(nrOfVertices());
+	for (std::size_t i = 0; i < nrOfVertices(); ++i)
+		m_heuristic[i] = static_cast<double>(h(graph, i, target));
+	m_heuristic_target = target;
+}
+
+inline bool WeightProfile::hasHeuristic() const
+{
+	return m_heuristic_target != nrOfVertices();
+}
+
+inline std::size_t WeightProfile::heuristicTarget() const
+{
+	return m_heuristic_target;
+}
+
+inline std::pair<double, std::vector<std::size_t>>
+WeightProfile::dijkstra(std::size_t start, std::size_t end) const
+{
+	SearchWorkspace<double> workspace{};
+	return dijkstra(start, end, workspace);
+}
+
+template <typename Heap>
+std::pair<double, std::vector<std::size_t>> WeightProfile::dijkstra(
+	std::size_t start,
+	std::size_t end,
+	SearchWorkspace<double, Heap>& workspace) const
+{
+	return search<false>(start, end, workspace);
+}
+
+inline std::pair<double, std::vector<std::size_t>>
+WeightProfile::a_star(std::size_t start, std::size_t end) const
+{
+	SearchWorkspace<double> workspace{};
+	return a_star(start, end, workspace);
+}
+
+template <typename Heap>
+std::pair<double, std::vector<std::size_t>> WeightProfile::a_star(
+	std::size_t start,
+	std::size_t end,
+	SearchWorkspace<double, Heap>& workspace) const
+{
+	if (!hasHeuristic() || end != m_heuristic_target)
+		throw std::logic_error{"Brak heurystyki dla tego celu"};
+	return search<true>(start, end, workspace);
+}
+
+template <bool Heuristic, typename Heap>
+std::pair<double, std::vector<std::size_t>> WeightProfile::search(
+	std::size_t start,
+	std::size_t end,
+	SearchWorkspace<double, Heap>& workspace) const
+{
+	workspace.reset(nrOfVertices());
+	auto& frontier = workspace.heap();
+	workspace.reach(start, 0, start);
+	frontier.push(start, 0);
+	const auto* targets = m_targets.data();
+	const auto* weights = m_weights.data();
+
+	while (!frontier.empty()) {
+		const auto current = frontier.top();
+		frontier.pop();
+		// outdated entry
+		if (workspace.settled(current))
+			continue;
+		const auto current_cost = workspace.distance(current);
+		if (current == end)
+			return std::make_pair(current_cost, workspace.path(end));
+
+		workspace.settle(current);
+		for (auto i = m_offsets[current]; i < m_offsets[current + 1]; ++i) {
+			const std::size_t node = targets[i];
+			if (workspace.settled(node))
+				continue;
+			const auto cost = current_cost + weights[i];
+			double key = cost;
+			if constexpr (Heuristic)
+				key += m_heuristic[node];
+			if (!workspace.reached(node)) {
+				workspace.reach(node, cost, current);
+				frontier.push(node, key);
+			} else if (cost < workspace.distance(node)) {
+				workspace.reach(node, cost, current);
+				frontier.decrease(node, key);
+			}
+		}
+	}
+	throw std::runtime_error{"No valid path"};
+}
+
+#endif /* WEIGHTPROFILE_HPP */
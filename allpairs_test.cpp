@@ -0,0 +1,87 @@
+#include "AllPairs.hpp"
+#include "Graph.hpp"
+#include "testing.hpp"
+#include <cassert>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+// distances against Graph::dijkstra on the original lengths, paths go over
+// edges of the graph and have the returned length
+void check(
+	const G& original,
+	const G& graph,
+	const std::vector<double>& potential,
+	const AllPairs& all)
+{
+	const auto infinity = std::numeric_limits<double>::infinity();
+	const auto vertices = graph.nrOfVertices();
+	assert(all.nrOfVertices() == vertices);
+	for (std::size_t s = 0; s < vertices; ++s) {
+		for (std::size_t t = 0; t < vertices; ++t) {
+			const auto expected
+				= distance(original, s, t) + potential[t] - potential[s];
+			assert(all.distance(s, t) == expected);
+			if (!all.hasNextHops())
+				continue;
+			try {
+				const auto [cost, path] = all.path(s, t);
+				assert(cost == expected);
+				assert(path.front() == s && path.back() == t);
+				assert(pathLength(graph, path) == cost);
+			} catch (const std::runtime_error&) {
+				assert(expected == infinity);
+			}
+		}
+	}
+}
+
+} // namespace
+
+int main()
+{
+	std::mt19937 rng{43};
+	for (std::size_t round = 0; round < 30; ++round) {
+		// some graphs span more than one tile
+		const auto vertices = 1 + rng() % (round % 3 == 0 ? 150 : 30);
+		const auto original
+			= randomGraph(rng, vertices, rng() % (4 * vertices));
+		auto graph = original;
+		std::vector<double> potential(vertices, 0.);
+		if (round % 2 == 0)
+			potential = reweight(rng, graph);
+		const auto next_hops = round % 4 < 2;
+		const auto all = AllPairs::build(graph, length, next_hops, 2);
+		assert(all.hasNextHops() == next_hops);
+		check(original, graph, potential, all);
+		if (!next_hops) {
+			bool thrown = false;
+			try {
+				all.path(0, 0);
+			} catch (const std::logic_error&) {
+				thrown = true;
+			}
+			assert(thrown);
+		}
+	}
+
+	// a negative cycle
+	auto graph = randomGraph(rng, 70, 200);
+	graph.insertEdge(10, 11, 1.);
+	graph.insertEdge(11, 12, 1.);
+	graph.insertEdge(12, 10, -3.);
+	bool thrown = false;
+	try {
+		AllPairs::build(graph, length);
+	} catch (const std::domain_error&) {
+		thrown = true;
+	}
+	assert(thrown);
+
+	std::cout << "allpairs_test: OK" << std::endl;
+	return 0;
+}
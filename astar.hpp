@@ -2,8 +2,10 @@
 #define ASTAR_HPP
 
 #include "Graph.hpp"
+#include <chrono>
 #include <cstdint>
 #include <functional>
+#include <limits>
 #include <utility>
 #include <vector>
 
@@ -17,7 +19,7 @@
 // przypadku - gdy etykieta jest długością - zwraca etykietę krawędzi)
 template <typename V, typename E>
 std::pair<double, std::vector<std::size_t>> astar(
-	Graph<V, E>& graph,
+	const Graph<V, E>& graph,
 	std::size_t start_idx,
 	std::size_t end_idx,
 	std::function<double(
@@ -29,4 +31,69 @@ std::pair<double, std::vector<std::size_t>> astar(
 	return graph.a_star(start_idx, end_idx, getEdgeLength, heuristics);
 }
 
+// wariant dwukierunkowy z uśrednionymi potencjałami (przeszukiwanie wstecz
+// wywołuje heurystykę jako heuristics(graph, start_idx, actual_vertex_id)),
+// heurystyka musi być spójna (monotoniczna), zwraca to samo co astar()
+template <typename V, typename E>
+std::pair<double, std::vector<std::size_t>> bidirectionalAstar(
+	const Graph<V, E>& graph,
+	std::size_t start_idx,
+	std::size_t end_idx,
+	std::function<double(
+		const Graph<V, E>&,
+		std::size_t actual_vertex_id,
+		std::size_t end_vertex_id)> heuristics,
+	std::function<double(const E&)> getEdgeLength)
+{
+	return graph.bidirectionalAStar(
+		start_idx, end_idx, getEdgeLength, heuristics);
+}
+
+// A* z heurystyką pomnożoną przez epsilon >= 1 - zwykle odwiedza znacznie mniej
+// wierzchołków, a znaleziona ścieżka jest co najwyżej epsilon razy dłuższa od
+// najkrótszej (pole bound wyniku podaje udowodnione ograniczenie, może być
+// mniejsze od epsilon), heurystyka musi być spójna (monotoniczna)
+template <typename V, typename E>
+typename Graph<V, E>::BoundedPath weightedAstar(
+	const Graph<V, E>& graph,
+	std::size_t start_idx,
+	std::size_t end_idx,
+	std::function<double(
+		const Graph<V, E>&,
+		std::size_t actual_vertex_id,
+		std::size_t end_vertex_id)> heuristics,
+	std::function<double(const E&)> getEdgeLength,
+	double epsilon)
+{
+	return graph.weightedAStar(
+		start_idx, end_idx, getEdgeLength, heuristics, epsilon);
+}
+
+// wariant "anytime" (ARA*) - pierwsza ścieżka jak w weightedAstar(), potem jest
+// poprawiana z coraz mniejszą wagą aż do udowodnienia, że jest najkrótsza,
+// upłynięcia czasu "deadline" albo odwiedzenia "expansions" wierzchołków
+template <typename V, typename E>
+typename Graph<V, E>::BoundedPath anytimeAstar(
+	const Graph<V, E>& graph,
+	std::size_t start_idx,
+	std::size_t end_idx,
+	std::function<double(
+		const Graph<V, E>&,
+		std::size_t actual_vertex_id,
+		std::size_t end_vertex_id)> heuristics,
+	std::function<double(const E&)> getEdgeLength,
+	double epsilon,
+	std::chrono::steady_clock::time_point deadline,
+	std::size_t expansions = std::numeric_limits<std::size_t>::max())
+{
+	return graph.anytimeAStar(
+		start_idx,
+		end_idx,
+		getEdgeLength,
+		heuristics,
+		epsilon,
+		deadline,
+		expansions);
+}
+
 #endif // ASTAR_HPP
@@ -0,0 +1,120 @@
+#include "Graph.hpp"
+#include "SearchWorkspace.hpp"
+#include "astar.hpp"
+#include "dijkstra.hpp"
+#include "testing.hpp"
+#include <cassert>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <stdexcept>
+
+namespace {
+
+// the search has to throw T
+template <typename T, typename Search>
+void assertThrows(Search search)
+{
+	bool thrown = false;
+	try {
+		search();
+	} catch (const T&) {
+		thrown = true;
+	}
+	assert(thrown);
+}
+
+} // namespace
+
+int main()
+{
+	std::mt19937 rng{34};
+	SearchWorkspace<double> forward;
+	SearchWorkspace<double> backward;
+	for (std::size_t round = 0; round < 300; ++round) {
+		const auto vertices = 1 + rng() % 40;
+		auto graph = randomGraph(rng, vertices, rng() % (3 * vertices));
+		const auto start = rng() % vertices;
+		for (std::size_t end = 0; end < vertices; ++end) {
+			const auto expected = distance(graph, start, end);
+			if (expected == std::numeric_limits<double>::infinity()) {
+				assertThrows<std::runtime_error>([&] {
+					graph.bidirectionalDijkstra(start, end, length);
+				});
+				continue;
+			}
+			const auto [cost, path]
+				= graph.bidirectionalDijkstra(start, end, length);
+			assert(cost == expected);
+			assert(path.front() == start && path.back() == end);
+			assert(pathLength(graph, path) == cost);
+			// reused workspaces give the same result
+			const auto reused = graph.bidirectionalDijkstra(
+				start, end, length, forward, backward);
+			assert(reused.first == expected && reused.second == path);
+			assert(
+				bidirectionalDijkstra(graph, start, end, length).first
+				== expected);
+		}
+	}
+
+	// points on a line, every edge is at least as long as the distance of
+	// its ends, so the distance on the line is a consistent heuristic
+	for (std::size_t round = 0; round < 300; ++round) {
+		const auto vertices = 1 + rng() % 40;
+		auto graph = randomGraph(rng, vertices, rng() % (3 * vertices));
+		std::vector<int> position(vertices);
+		for (auto& p : position)
+			p = static_cast<int>(rng() % 30);
+		for (std::size_t u = 0; u < vertices; ++u)
+			for (std::size_t v = 0; v < vertices; ++v)
+				if (graph.edgeExist(u, v))
+					graph.insertEdge(
+						u,
+						v,
+						std::abs(position[u] - position[v])
+							+ graph.edgeLabel(u, v));
+		const auto h = [&](const G&, std::size_t u, std::size_t v) {
+			return static_cast<double>(std::abs(position[u] - position[v]));
+		};
+
+		const auto start = rng() % vertices;
+		for (std::size_t end = 0; end < vertices; ++end) {
+			const auto expected = distance(graph, start, end);
+			if (expected == std::numeric_limits<double>::infinity()) {
+				assertThrows<std::runtime_error>(
+					[&] { graph.bidirectionalAStar(start, end, length, h); });
+				continue;
+			}
+			const auto [cost, path]
+				= graph.bidirectionalAStar(start, end, length, h);
+			assert(cost == expected);
+			assert(path.front() == start && path.back() == end);
+			assert(pathLength(graph, path) == cost);
+			const auto free = bidirectionalAstar<int, double>(
+				graph, start, end, h, length);
+			assert(free.first == expected);
+		}
+	}
+
+	// a negative length is found by the forward and by the backward search
+	auto graph = randomGraph(rng, 4, 0);
+	graph.insertEdge(0, 1, -1.);
+	graph.insertEdge(1, 2, 5.);
+	graph.insertEdge(2, 3, -1.);
+	assertThrows<std::domain_error>(
+		[&] { graph.bidirectionalDijkstra(0, 2, length); });
+	assertThrows<std::domain_error>(
+		[&] { graph.bidirectionalDijkstra(1, 3, length); });
+	assertThrows<std::domain_error>([&] {
+		graph.bidirectionalDijkstra(
+			0, 3, [](const double& e) { return static_cast<int>(e); });
+	});
+	const auto zero = [](const G&, std::size_t, std::size_t) { return 0.; };
+	assertThrows<std::domain_error>(
+		[&] { graph.bidirectionalAStar(1, 3, length, zero); });
+
+	std::cout << "bidirectional_test: OK" << std::endl;
+	return 0;
+}
@@ -0,0 +1,131 @@
+#include "Graph.hpp"
+#include "testing.hpp"
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace {
+
+// vertices are points of a plane, edges are at least as long as the segment
+// between their ends, so the straight-line distance is a consistent heuristic
+struct Plane {
+	G graph{};
+	std::vector<std::pair<double, double>> points{};
+
+	double operator()(const G&, std::size_t from, std::size_t to) const
+	{
+		return std::hypot(
+			points[from].first - points[to].first,
+			points[from].second - points[to].second);
+	}
+};
+
+Plane randomPlane(std::mt19937& rng, std::size_t vertices, std::size_t edges)
+{
+	Plane out{};
+	for (std::size_t i = 0; i < vertices; ++i) {
+		out.graph.insertVertex(static_cast<int>(i));
+		out.points.emplace_back(rng() % 100, rng() % 100);
+	}
+	for (std::size_t i = 0; i < edges; ++i) {
+		const auto from = rng() % vertices;
+		const auto to = rng() % vertices;
+		const auto stretch = 1 + static_cast<double>(rng() % 3) / 2;
+		out.graph.insertEdge(from, to, stretch * out(out.graph, from, to));
+	}
+	return out;
+}
+
+bool atMost(double a, double b)
+{
+	return a <= b + 1e-9 * (1 + std::abs(b));
+}
+
+// the path is valid, of the reported length and within the reported bound,
+// which is within epsilon
+void check(
+	const Plane& plane,
+	const G::BoundedPath& found,
+	std::size_t start,
+	std::size_t end,
+	double optimal,
+	double epsilon)
+{
+	const auto& path = found.path;
+	assert(path.front() == start && path.back() == end);
+	const auto sum = pathLength(plane.graph, path);
+	assert(atMost(sum, found.length) && atMost(found.length, sum));
+	assert(found.bound >= 1 && atMost(found.bound, epsilon));
+	assert(atMost(optimal, found.length));
+	assert(atMost(found.length, found.bound * optimal));
+}
+
+} // namespace
+
+int main()
+{
+	std::mt19937 rng{50};
+	const auto no_deadline
+		= std::chrono::steady_clock::now() + std::chrono::hours{1};
+	for (std::size_t round = 0; round < 200; ++round) {
+		const auto vertices = 1 + rng() % 40;
+		const auto plane = randomPlane(rng, vertices, rng() % (4 * vertices));
+		const auto& graph = plane.graph;
+		const auto start = rng() % vertices;
+		const auto end = rng() % vertices;
+		const auto epsilon = 1 + static_cast<double>(rng() % 5) / 2;
+
+		const auto optimal = distance(graph, start, end);
+		if (optimal == std::numeric_limits<double>::infinity()) {
+			bool thrown = false;
+			try {
+				graph.weightedAStar(start, end, length, plane, epsilon);
+			} catch (const std::runtime_error&) {
+				thrown = true;
+			}
+			assert(thrown);
+			continue;
+		}
+
+		check(
+			plane,
+			graph.weightedAStar(start, end, length, plane, epsilon),
+			start,
+			end,
+			optimal,
+			epsilon);
+		// a few expansions only, the first search still finishes
+		check(
+			plane,
+			graph.anytimeAStar(
+				start, end, length, plane, epsilon, no_deadline, rng() % 10),
+			start,
+			end,
+			optimal,
+			epsilon);
+		// without limits the path is proven shortest
+		const auto best = graph.anytimeAStar(
+			start, end, length, plane, epsilon, no_deadline);
+		check(plane, best, start, end, optimal, epsilon);
+		assert(best.bound == 1);
+	}
+
+	bool thrown = false;
+	try {
+		std::mt19937 plane_rng{500};
+		const auto plane = randomPlane(plane_rng, 10, 30);
+		plane.graph.weightedAStar(0, 1, length, plane, 0.5);
+	} catch (const std::domain_error&) {
+		thrown = true;
+	}
+	assert(thrown);
+
+	std::cout << "boundedastar_test: OK" << std::endl;
+	return 0;
+}
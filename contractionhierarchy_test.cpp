@@ -0,0 +1,147 @@
+#include "ContractionHierarchy.hpp"
+#include "Graph.hpp"
+#include "ThreadPool.hpp"
+#include "testing.hpp"
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+// queries of every pair against Graph::dijkstra, paths go over edges of the
+// graph and have the returned length
+void checkQueries(const G& graph, const ContractionHierarchy& hierarchy)
+{
+	assert(hierarchy.nrOfVertices() == graph.nrOfVertices());
+	for (std::size_t s = 0; s < graph.nrOfVertices(); ++s)
+		for (std::size_t t = 0; t < graph.nrOfVertices(); ++t) {
+			const auto expected = distance(graph, s, t);
+			try {
+				const auto [cost, path] = hierarchy.query(s, t);
+				assert(cost == expected);
+				assert(path.front() == s && path.back() == t);
+				assert(pathLength(graph, path) == cost);
+			} catch (const std::runtime_error&) {
+				assert(expected == std::numeric_limits<double>::infinity());
+			}
+		}
+}
+
+template <typename T>
+void assertThrows(const std::string& data)
+{
+	std::stringstream stream{data};
+	bool thrown = false;
+	try {
+		ContractionHierarchy::load(stream);
+	} catch (const T&) {
+		thrown = true;
+	}
+	assert(thrown);
+}
+
+// the data with a value written over the bytes at the position
+template <typename T>
+std::string patched(std::string data, std::size_t position, T value)
+{
+	std::memcpy(&data[position], &value, sizeof(value));
+	return data;
+}
+
+// broken files are rejected, positions follow the layout of save(): magic,
+// then ranks, up offsets, up arcs, down offsets and down arcs, each as a
+// 64 bit size and the elements (4 byte ranks, 8 byte offsets, 16 byte arcs
+// of node, middle and length)
+void checkCorrupted(const std::string& data, std::size_t vertices)
+{
+	const std::size_t ranks = 4 + 8;
+	const std::size_t up_offsets = ranks + 4 * vertices + 8;
+	const std::size_t up = up_offsets + 8 * (vertices + 1) + 8;
+	std::uint64_t up_size;
+	std::memcpy(&up_size, &data[up - 8], sizeof(up_size));
+	const auto none = std::numeric_limits<std::uint32_t>::max();
+
+	assertThrows<std::runtime_error>(patched(data, 0, 'X'));
+	for (std::size_t length = 0; length < data.size(); length += 7)
+		assertThrows<std::runtime_error>(data.substr(0, length));
+	// a huge size is rejected before anything is allocated
+	assertThrows<std::runtime_error>(
+		patched(data, ranks - 8, std::uint64_t{1} << 60));
+	if (vertices >= 2) {
+		// two vertices with the same rank
+		std::uint32_t rank;
+		std::memcpy(&rank, &data[ranks + 4], sizeof(rank));
+		assertThrows<std::runtime_error>(patched(data, ranks, rank));
+	}
+	// rank out of range
+	assertThrows<std::runtime_error>(
+		patched(data, ranks, static_cast<std::uint32_t>(vertices)));
+	// offsets going back
+	if (up_size > 0)
+		assertThrows<std::runtime_error>(
+			patched(data, up_offsets + 8, up_size + 1));
+	if (up_size > 0) {
+		// arc to a vertex out of range, or a middle vertex out of range
+		assertThrows<std::runtime_error>(
+			patched(data, up, static_cast<std::uint32_t>(vertices)));
+		assertThrows<std::runtime_error>(
+			patched(data, up + 4, static_cast<std::uint32_t>(vertices)));
+		assertThrows<std::runtime_error>(patched(data, up + 4, none - 1));
+	}
+}
+
+} // namespace
+
+int main()
+{
+	std::mt19937 rng{36};
+	ThreadPool pool{2};
+	for (std::size_t round = 0; round < 50; ++round) {
+		const auto vertices = 1 + rng() % 30;
+		const auto graph = randomGraph(rng, vertices, rng() % (4 * vertices));
+		const auto hierarchy = ContractionHierarchy::build(graph, length);
+		checkQueries(graph, hierarchy);
+
+		// targets may repeat
+		std::vector<std::size_t> sources;
+		std::vector<std::size_t> targets;
+		for (std::size_t i = rng() % 8; i > 0; --i)
+			sources.push_back(rng() % vertices);
+		for (std::size_t i = rng() % 8; i > 0; --i)
+			targets.push_back(rng() % vertices);
+		const auto expected = graph.distanceTable(sources, targets, length);
+		assert(hierarchy.distanceTable(sources, targets) == expected);
+		assert(hierarchy.distanceTable(sources, targets, pool) == expected);
+
+		std::stringstream stream;
+		hierarchy.save(stream);
+		const auto data = stream.str();
+		const auto loaded = ContractionHierarchy::load(stream);
+		for (std::size_t i = 0; i < vertices; ++i)
+			assert(loaded.rank(i) == hierarchy.rank(i));
+		checkQueries(graph, loaded);
+		assert(loaded.distanceTable(sources, targets) == expected);
+		checkCorrupted(data, vertices);
+	}
+
+	// negative lengths are rejected
+	auto graph = randomGraph(rng, 3, 0);
+	graph.insertEdge(0, 1, 1.);
+	graph.insertEdge(1, 2, -1.);
+	bool thrown = false;
+	try {
+		ContractionHierarchy::build(graph, length);
+	} catch (const std::domain_error&) {
+		thrown = true;
+	}
+	assert(thrown);
+
+	std::cout << "contractionhierarchy_test: OK" << std::endl;
+	return 0;
+}
@@ -0,0 +1,66 @@
+#include "Graph.hpp"
+#include "ThreadPool.hpp"
+#include "testing.hpp"
+#include <cassert>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+template <typename Exception, typename Search>
+void assertThrows(Search search)
+{
+	bool thrown = false;
+	try {
+		search();
+	} catch (const Exception&) {
+		thrown = true;
+	}
+	assert(thrown);
+}
+
+} // namespace
+
+int main()
+{
+	const auto int_length = [](const double& e) { return static_cast<int>(e); };
+	std::mt19937 rng{42};
+	ThreadPool pool{3};
+	for (std::size_t round = 0; round < 200; ++round) {
+		const auto vertices = 1 + rng() % 60;
+		const auto graph = randomGraph(rng, vertices, rng() % (4 * vertices));
+		const auto source = rng() % vertices;
+		std::vector<double> expected(vertices);
+		for (std::size_t v = 0; v < vertices; ++v)
+			expected[v] = distance(graph, source, v);
+
+		// buckets narrower and wider than the lengths, zero lengths included
+		for (const auto delta : {0.5, 1., 3., 100.}) {
+			for (std::size_t threads : {1, 4, 0})
+				assert(
+					graph.deltaStepping(source, length, delta, threads)
+					== expected);
+			assert(
+				graph.deltaStepping(source, length, delta, pool) == expected);
+			assert(
+				graph.deltaStepping(source, int_length, delta, pool)
+				== expected);
+		}
+	}
+
+	auto graph = randomGraph(rng, 3, 0);
+	graph.insertEdge(0, 1, 1.);
+	graph.insertEdge(1, 2, -1.);
+	for (const auto delta : {0., -1.})
+		assertThrows<std::domain_error>(
+			[&] { graph.deltaStepping(0, length, delta, pool); });
+	assertThrows<std::domain_error>(
+		[&] { graph.deltaStepping(0, length, 1., pool); });
+	assertThrows<std::domain_error>(
+		[&] { graph.deltaStepping(0, int_length, 1., pool); });
+
+	std::cout << "deltastepping_test: OK" << std::endl;
+	return 0;
+}
@@ -0,0 +1,72 @@
+#include "Graph.hpp"
+#include "testing.hpp"
+#include <cassert>
+#include <iostream>
+#include <random>
+#include <tuple>
+#include <vector>
+
+using Event = G::DFSIterator::Event;
+// event, vertex and depth() after it
+using Step = std::tuple<Event, std::size_t, std::size_t>;
+
+namespace {
+
+// recursive DFS scanning neighbours by id, as the iterator does
+void reference(
+	const G& graph,
+	std::size_t node,
+	std::size_t depth,
+	std::vector<char>& visited,
+	std::vector<Step>& out)
+{
+	for (std::size_t i = 0; i < graph.nrOfVertices(); ++i) {
+		if (!graph.edgeExist(node, i) || visited[i])
+			continue;
+		visited[i] = 1;
+		out.emplace_back(Event::DISCOVER, i, depth + 1);
+		reference(graph, i, depth + 1, visited, out);
+	}
+	out.emplace_back(Event::FINISH, node, depth - 1);
+}
+
+} // namespace
+
+int main()
+{
+	std::mt19937 rng{26};
+	for (std::size_t round = 0; round < 200; ++round) {
+		const auto vertices = 1 + rng() % 30;
+		const auto graph = randomGraph(rng, vertices, rng() % (3 * vertices));
+		const auto start = rng() % vertices;
+
+		std::vector<char> visited(vertices, 0);
+		visited[start] = 1;
+		std::vector<Step> expected{{Event::DISCOVER, start, 1}};
+		reference(graph, start, 1, visited, expected);
+
+		// every discovery and finish event, each vertex once
+		auto it = graph.beginDFS(start);
+		std::vector<Step> events{{Event::DISCOVER, it.id(), it.depth()}};
+		for (auto event = it.step(); event != Event::END; event = it.step())
+			events.emplace_back(event, it.id(), it.depth());
+		assert(events == expected);
+		assert(it == graph.endDFS());
+
+		// operator++ stops at discoveries only
+		std::vector<std::size_t> preorder;
+		for (auto vertex = graph.beginDFS(start); vertex != graph.endDFS();
+			 ++vertex) {
+			assert(static_cast<std::size_t>(*vertex) == vertex.id());
+			preorder.push_back(vertex.id());
+		}
+		std::vector<std::size_t> discovered;
+		for (const auto& [event, node, depth] : expected)
+			if (event == Event::DISCOVER)
+				discovered.push_back(node);
+		assert(preorder == discovered);
+	}
+
+	std::cout << "dfsiterator_test: OK" << std::endl;
+	return 0;
+}
@@ -2,8 +2,10 @@
 #define DIJKSTRA_HPP
 
 #include "Graph.hpp"
+#include <algorithm>
 #include <cstdint>
 #include <functional>
+#include <stdexcept>
 #include <utility>
 #include <vector>
 
@@ -16,7 +18,7 @@
 // przypadku - gdy etykieta jest długością - zwraca etykietę krawędzi)
 template <typename V, typename E>
 std::pair<double, std::vector<std::size_t>> dijkstra(
-	Graph<V, E>& graph,
+	const Graph<V, E>& graph,
 	std::size_t start_idx,
 	std::size_t end_idx,
 	std::function<double(const E&)> getEdgeLength)
@@ -24,4 +26,63 @@ std::pair<double, std::vector<std::size_t>> dijkstra(
 	return graph.dijkstra(start_idx, end_idx, getEdgeLength);
 }
 
+// to samo dla dowolnego funktora - typ długości krawędzi jest znany w czasie
+// kompilacji, dla długości całkowitych używany jest kopiec pozycyjny (radix
+// heap) zamiast kopca binarnego
+template <typename V, typename E, typename F>
+std::pair<double, std::vector<std::size_t>> dijkstra(
+	const Graph<V, E>& graph,
+	std::size_t start_idx,
+	std::size_t end_idx,
+	F getEdgeLength)
+{
+	return graph.dijkstra(start_idx, end_idx, getEdgeLength);
+}
+
+// wariant dwukierunkowy - przeszukiwanie prowadzone jednocześnie od początku i
+// od końca (po krawędziach wchodzących), zwraca to samo co dijkstra()
+template <typename V, typename E, typename F>
+std::pair<double, std::vector<std::size_t>> bidirectionalDijkstra(
+	const Graph<V, E>& graph,
+	std::size_t start_idx,
+	std::size_t end_idx,
+	F getEdgeLength)
+{
+	return graph.bidirectionalDijkstra(start_idx, end_idx, getEdgeLength);
+}
+
+// to samo dla ujemnych długości krawędzi (algorytm Bellmana-Forda), ujemny
+// cykl osiągalny z wierzchołka początkowego zgłasza std::domain_error,
+// każde wywołanie uruchamia i kończy własne wątki (jak Graph::bellmanFord)
+template <typename V, typename E, typename F>
+std::pair<double, std::vector<std::size_t>> bellmanFord(
+	const Graph<V, E>& graph,
+	std::size_t start_idx,
+	std::size_t end_idx,
+	F getEdgeLength)
+{
+	const auto tree = graph.bellmanFord(start_idx, getEdgeLength);
+	if (tree.parent[end_idx] == graph.nrOfVertices())
+		throw std::runtime_error{"No valid path"};
+	std::vector<std::size_t> path{end_idx};
+	for (auto node = end_idx; node != start_idx; node = tree.parent[node])
+		path.push_back(tree.parent[node]);
+	std::reverse(path.begin(), path.end());
+	return std::make_pair(tree.distance[end_idx], path);
+}
+
+// k najkrótszych ścieżek prostych (bez powtórzeń wierzchołków) w kolejności
+// rosnącej długości, każda w tym samym formacie co wynik dijkstra(), gdy
+// takich ścieżek jest mniej zwraca wszystkie, graf nie jest modyfikowany
+template <typename V, typename E, typename F>
+std::vector<std::pair<double, std::vector<std::size_t>>> kShortestPaths(
+	const Graph<V, E>& graph,
+	std::size_t start_idx,
+	std::size_t end_idx,
+	std::size_t k,
+	F getEdgeLength)
+{
+	return graph.kShortestPaths(start_idx, end_idx, k, getEdgeLength);
+}
+
 #endif // DIJKSTRA_HPP
@@ -0,0 +1,41 @@
+#include "Graph.hpp"
+#include "ThreadPool.hpp"
+#include "testing.hpp"
+#include <cassert>
+#include <iostream>
+#include <random>
+#include <vector>
+
+int main()
+{
+	const auto int_length = [](const double& e) { return static_cast<int>(e); };
+	std::mt19937 rng{40};
+	ThreadPool pool{3};
+	for (std::size_t round = 0; round < 200; ++round) {
+		const auto vertices = 1 + rng() % 40;
+		const auto graph = randomGraph(rng, vertices, rng() % (3 * vertices));
+		// sources and targets may repeat and be empty
+		std::vector<std::size_t> sources(rng() % 10);
+		for (auto& source : sources)
+			source = rng() % vertices;
+		std::vector<std::size_t> targets(rng() % 10);
+		for (auto& target : targets)
+			target = rng() % vertices;
+
+		// row major, one row per source
+		std::vector<double> expected;
+		for (const auto source : sources)
+			for (const auto target : targets)
+				expected.push_back(distance(graph, source, target));
+		assert(graph.distanceTable(sources, targets, length) == expected);
+		for (std::size_t threads : {0, 1, 4})
+			assert(
+				graph.distanceTable(sources, targets, length, threads)
+				== expected);
+		assert(graph.distanceTable(sources, targets, length, pool) == expected);
+		assert(graph.distanceTable(sources, targets, int_length) == expected);
+	}
+
+	std::cout << "distancetable_test: OK" << std::endl;
+	return 0;
+}
@@ -0,0 +1,95 @@
+#include "DynamicShortestPaths.hpp"
+#include "Graph.hpp"
+#include "testing.hpp"
+#include <cassert>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace {
+
+using Tree = DynamicShortestPaths<int, double, decltype(length)>;
+
+// distances of a fresh Dijkstra, parents and paths match them
+void check(const G& graph, const Tree& tree)
+{
+	const auto vertices = graph.nrOfVertices();
+	const auto infinity = std::numeric_limits<double>::infinity();
+	for (std::size_t v = 0; v < vertices; ++v) {
+		const auto expected = distance(graph, tree.source(), v);
+		assert(tree.distance(v) == expected);
+		if (expected == infinity) {
+			assert(tree.parent(v) == vertices);
+			bool thrown = false;
+			try {
+				tree.path(v);
+			} catch (const std::runtime_error&) {
+				thrown = true;
+			}
+			assert(thrown);
+			continue;
+		}
+		const auto parent = tree.parent(v);
+		if (v == tree.source()) {
+			assert(parent == v);
+		} else {
+			assert(graph.edgeExist(parent, v));
+			assert(
+				tree.distance(parent) + graph.edgeLabel(parent, v)
+				== expected);
+		}
+		const auto path = tree.path(v);
+		assert(path.front() == tree.source() && path.back() == v);
+		assert(pathLength(graph, path) == expected);
+	}
+}
+
+} // namespace
+
+int main()
+{
+	const auto infinity = std::numeric_limits<double>::infinity();
+	std::mt19937 rng{46};
+	std::size_t lost = 0;
+	for (std::size_t round = 0; round < 100; ++round) {
+		const auto vertices = 1 + rng() % 30;
+		auto graph = randomGraph(rng, vertices, rng() % (3 * vertices));
+		Tree tree{graph, rng() % vertices, length};
+		check(graph, tree);
+		for (std::size_t step = 0; step < 50; ++step) {
+			// one edge or a batch, updated after all of them changed
+			std::vector<std::pair<std::size_t, std::size_t>> changed;
+			std::vector<double> before(vertices);
+			for (std::size_t v = 0; v < vertices; ++v)
+				before[v] = tree.distance(v);
+			for (std::size_t i = step % 2 == 0 ? 1 : 1 + rng() % 5; i > 0;
+				 --i) {
+				const auto from = rng() % vertices;
+				const auto to = rng() % vertices;
+				const auto label = static_cast<double>(rng() % 10);
+				if (!graph.edgeExist(from, to)) {
+					graph.insertEdge(from, to, label);
+				} else if (rng() % 3 == 0) {
+					graph.removeEdge(from, to);
+				} else {
+					// longer or shorter than before
+					graph.setEdgeLabel(from, to, label);
+				}
+				changed.emplace_back(from, to);
+			}
+			for (const auto& [from, to] : changed)
+				tree.update(from, to);
+			check(graph, tree);
+			for (std::size_t v = 0; v < vertices; ++v)
+				lost += before[v] != infinity && tree.distance(v) == infinity;
+		}
+	}
+	// removals cut vertices off the tree
+	assert(lost > 0);
+
+	std::cout << "dynamicshortestpaths_test: OK" << std::endl;
+	return 0;
+}
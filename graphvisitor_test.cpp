@@ -0,0 +1,141 @@
+#include "Graph.hpp"
+#include "testing.hpp"
+#include <algorithm>
+#include <cassert>
+#include <iostream>
+#include <random>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+enum class Hook { DISCOVER, EXAMINE, FINISH };
+// hook and its arguments, the second vertex only for examine_edge
+using Call = std::tuple<Hook, std::size_t, std::size_t>;
+
+namespace {
+
+// records every call, returns false from call number limit on
+struct Recorder : GraphVisitor {
+	std::vector<Call>& calls;
+	std::size_t limit;
+
+	bool record(Hook hook, std::size_t u, std::size_t v)
+	{
+		calls.emplace_back(hook, u, v);
+		return calls.size() < limit;
+	}
+	bool discover_vertex(std::size_t u, const G&)
+	{
+		return record(Hook::DISCOVER, u, 0);
+	}
+	bool examine_edge(std::size_t u, std::size_t v, const G&)
+	{
+		return record(Hook::EXAMINE, u, v);
+	}
+	bool finish_vertex(std::size_t u, const G&)
+	{
+		return record(Hook::FINISH, u, 0);
+	}
+};
+
+std::vector<Call> bfsReference(const G& graph, std::size_t start)
+{
+	std::vector<Call> out{{Hook::DISCOVER, start, 0}};
+	std::vector<char> visited(graph.nrOfVertices(), 0);
+	std::vector<std::size_t> queue{start};
+	visited[start] = 1;
+	for (std::size_t head = 0; head < queue.size(); ++head) {
+		const auto u = queue[head];
+		for (std::size_t v = 0; v < graph.nrOfVertices(); ++v) {
+			if (!graph.edgeExist(u, v))
+				continue;
+			out.emplace_back(Hook::EXAMINE, u, v);
+			if (visited[v])
+				continue;
+			visited[v] = 1;
+			out.emplace_back(Hook::DISCOVER, v, 0);
+			queue.push_back(v);
+		}
+		out.emplace_back(Hook::FINISH, u, 0);
+	}
+	return out;
+}
+
+void dfsReference(
+	const G& graph,
+	std::size_t u,
+	std::vector<char>& visited,
+	std::vector<Call>& out)
+{
+	for (std::size_t v = 0; v < graph.nrOfVertices(); ++v) {
+		if (!graph.edgeExist(u, v))
+			continue;
+		out.emplace_back(Hook::EXAMINE, u, v);
+		if (visited[v])
+			continue;
+		visited[v] = 1;
+		out.emplace_back(Hook::DISCOVER, v, 0);
+		dfsReference(graph, v, visited, out);
+	}
+	out.emplace_back(Hook::FINISH, u, 0);
+}
+
+std::vector<Call> dfsReference(const G& graph, std::size_t start)
+{
+	std::vector<Call> out{{Hook::DISCOVER, start, 0}};
+	std::vector<char> visited(graph.nrOfVertices(), 0);
+	visited[start] = 1;
+	dfsReference(graph, start, visited, out);
+	return out;
+}
+
+// the full traversal, then one stopped by the hook call number limit
+template <typename Traversal>
+void check(
+	Traversal traversal,
+	const std::vector<Call>& expected,
+	std::size_t limit)
+{
+	std::vector<Call> calls;
+	assert(traversal(Recorder{{}, calls, expected.size() + 1}));
+	assert(calls == expected);
+
+	calls.clear();
+	assert(!traversal(Recorder{{}, calls, limit}));
+	assert(calls.size() == limit);
+	assert(std::equal(calls.begin(), calls.end(), expected.begin()));
+}
+
+} // namespace
+
+int main()
+{
+	std::mt19937 rng{27};
+	for (std::size_t round = 0; round < 200; ++round) {
+		const auto vertices = 1 + rng() % 30;
+		const auto graph = randomGraph(rng, vertices, rng() % (3 * vertices));
+		const auto start = rng() % vertices;
+
+		const auto bfs = bfsReference(graph, start);
+		check(
+			[&](Recorder&& visitor) {
+				return graph.bfsVisit(start, std::move(visitor));
+			},
+			bfs,
+			1 + rng() % bfs.size());
+		const auto dfs = dfsReference(graph, start);
+		check(
+			[&](Recorder&& visitor) {
+				return graph.dfsVisit(start, std::move(visitor));
+			},
+			dfs,
+			1 + rng() % dfs.size());
+
+		// the default hooks of the base class never stop
+		assert(graph.bfsVisit(start, GraphVisitor{}));
+		assert(graph.dfsVisit(start, GraphVisitor{}));
+	}
+
+	std::cout << "graphvisitor_test: OK" << std::endl;
+	return 0;
+}
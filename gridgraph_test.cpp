@@ -0,0 +1,154 @@
+#include "Graph.hpp"
+#include "GridGraph.hpp"
+#include "testing.hpp"
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+// the same grid as an adjacency matrix, corners may be cut as in GridGraph
+G toGraph(const GridGraph& grid)
+{
+	G graph;
+	for (std::size_t i = 0; i < grid.nrOfVertices(); ++i)
+		graph.insertVertex(static_cast<int>(i));
+	const auto width = static_cast<std::ptrdiff_t>(grid.width());
+	const auto height = static_cast<std::ptrdiff_t>(grid.height());
+	for (std::ptrdiff_t y = 0; y < height; ++y)
+		for (std::ptrdiff_t x = 0; x < width; ++x) {
+			const auto from = grid.cell(
+				static_cast<std::size_t>(x), static_cast<std::size_t>(y));
+			if (grid.blocked(from))
+				continue;
+			for (std::ptrdiff_t dy = -1; dy <= 1; ++dy)
+				for (std::ptrdiff_t dx = -1; dx <= 1; ++dx) {
+					const auto nx = x + dx;
+					const auto ny = y + dy;
+					if ((dx == 0 && dy == 0) || nx < 0 || ny < 0
+						|| nx >= width || ny >= height)
+						continue;
+					const auto to = grid.cell(
+						static_cast<std::size_t>(nx),
+						static_cast<std::size_t>(ny));
+					if (!grid.blocked(to))
+						graph.insertEdge(
+							from, to, dx != 0 && dy != 0 ? std::sqrt(2.) : 1.);
+				}
+		}
+	return graph;
+}
+
+GridGraph randomGrid(std::mt19937& rng, std::size_t width, std::size_t height)
+{
+	GridGraph grid{width, height};
+	const auto percent = rng() % 50;
+	for (std::size_t i = 0; i < grid.nrOfVertices(); ++i)
+		if (rng() % 100 < percent)
+			grid.setBlocked(i);
+	return grid;
+}
+
+bool near(double a, double b)
+{
+	return std::abs(a - b) < 1e-9 * (1 + std::abs(a));
+}
+
+// the path of jumpPointSearch against Graph::dijkstra
+void check(
+	const G& graph,
+	const GridGraph& grid,
+	std::size_t start,
+	std::size_t end,
+	SearchWorkspace<double>& workspace)
+{
+	const auto expected = grid.blocked(start) || grid.blocked(end)
+		? std::numeric_limits<double>::infinity()
+		: distance(graph, start, end);
+	try {
+		const auto [cost, path] = grid.jumpPointSearch(start, end, workspace);
+		assert(near(cost, expected));
+		assert(path.front() == start && path.back() == end);
+		assert(near(pathLength(graph, path), cost));
+	} catch (const std::runtime_error&) {
+		assert(expected == std::numeric_limits<double>::infinity());
+	}
+}
+
+} // namespace
+
+int main()
+{
+	std::mt19937 rng{48};
+	SearchWorkspace<double> workspace{};
+	for (std::size_t round = 0; round < 500; ++round) {
+		// some grids wider than the 64 cells of one scan
+		const auto width = 1 + rng() % (round % 5 == 0 ? 150 : 14);
+		const auto height = 1 + rng() % 14;
+		const auto grid = randomGrid(rng, width, height);
+		const auto graph = toGraph(grid);
+		for (std::size_t query = 0; query < 10; ++query)
+			check(
+				graph,
+				grid,
+				rng() % grid.nrOfVertices(),
+				rng() % grid.nrOfVertices(),
+				workspace);
+	}
+
+	// benchmark: Graph::a_star with the octile heuristic on a 128x128 grid
+	// with 20% of the cells blocked
+	const std::size_t side = 128;
+	GridGraph grid{side, side};
+	for (std::size_t i = 0; i < grid.nrOfVertices(); ++i)
+		if (rng() % 100 < 20)
+			grid.setBlocked(i);
+	const auto graph = toGraph(grid);
+	const auto octile = [&](const G&, std::size_t from, std::size_t to) {
+		const auto dx = std::abs(
+			static_cast<double>(grid.column(from))
+			- static_cast<double>(grid.column(to)));
+		const auto dy = std::abs(
+			static_cast<double>(grid.row(from))
+			- static_cast<double>(grid.row(to)));
+		return std::min(dx, dy) * std::sqrt(2.) + std::abs(dx - dy);
+	};
+	std::vector<std::pair<std::size_t, std::size_t>> queries;
+	while (queries.size() < 20) {
+		const auto start = rng() % grid.nrOfVertices();
+		const auto end = rng() % grid.nrOfVertices();
+		if (!grid.blocked(start) && !grid.blocked(end))
+			queries.emplace_back(start, end);
+	}
+	using Clock = std::chrono::steady_clock;
+	double a_star_total = 0;
+	double jps_total = 0;
+	const auto begin = Clock::now();
+	for (const auto& [start, end] : queries)
+		try {
+			a_star_total += graph.a_star(start, end, length, octile).first;
+		} catch (const std::runtime_error&) {
+		}
+	const auto middle = Clock::now();
+	for (const auto& [start, end] : queries)
+		try {
+			jps_total += grid.jumpPointSearch(start, end, workspace).first;
+		} catch (const std::runtime_error&) {
+		}
+	const auto finish = Clock::now();
+	assert(near(a_star_total, jps_total));
+	const std::chrono::duration<double, std::milli> a_star_time
+		= middle - begin;
+	const std::chrono::duration<double, std::milli> jps_time = finish - middle;
+	std::cout << "gridgraph_test: a_star " << a_star_time.count()
+			  << " ms, jumpPointSearch " << jps_time.count() << " ms"
+			  << std::endl;
+
+	std::cout << "gridgraph_test: OK" << std::endl;
+	return 0;
+}
@@ -0,0 +1,110 @@
+#include "IndexedHeap.hpp"
+#include "LazyHeap.hpp"
+#include "RadixHeap.hpp"
+#include <cassert>
+#include <iostream>
+#include <map>
+#include <random>
+#include <set>
+#include <utility>
+
+namespace {
+
+// random pushes, decreases and pops against the current key of every id
+template <typename Heap>
+void checkIndexed(std::mt19937& rng)
+{
+	constexpr std::size_t ids = 200;
+	Heap heap;
+	std::map<std::size_t, std::size_t> keys;
+	for (std::size_t round = 0; round < 20; ++round) {
+		// a cleared heap is reused, ids of the previous round are gone
+		heap.clear(ids);
+		keys.clear();
+		for (std::size_t step = 0; step < 2000; ++step) {
+			const auto id = rng() % ids;
+			const auto action = rng() % 3;
+			if (action == 0 && !keys.empty()) {
+				std::size_t lowest = keys.begin()->second;
+				for (const auto& [i, key] : keys)
+					lowest = std::min(lowest, key);
+				assert(heap.topKey() == lowest);
+				assert(keys.at(heap.top()) == lowest);
+				keys.erase(heap.top());
+				heap.pop();
+			} else if (keys.count(id) != 0) {
+				assert(heap.contains(id));
+				const auto key = keys[id] - rng() % (keys[id] + 1);
+				keys[id] = key;
+				heap.decrease(id, key);
+			} else {
+				assert(!heap.contains(id));
+				keys[id] = rng() % 1000;
+				heap.push(id, keys[id]);
+			}
+			assert(heap.size() == keys.size());
+			assert(heap.empty() == keys.empty());
+		}
+		// popping everything gives non-decreasing keys
+		std::size_t last = 0;
+		while (!heap.empty()) {
+			assert(heap.topKey() >= last);
+			last = heap.topKey();
+			assert(keys.at(heap.top()) == last);
+			keys.erase(heap.top());
+			heap.pop();
+		}
+		assert(keys.empty());
+	}
+}
+
+// decrease() adds another entry, the old one stays until it is popped
+// a monotone heap only gets keys not below the last minimum
+template <typename Heap>
+void checkLazy(std::mt19937& rng, bool monotone)
+{
+	Heap heap;
+	std::multiset<std::pair<std::size_t, std::size_t>> entries;
+	for (std::size_t round = 0; round < 20; ++round) {
+		heap.clear(0);
+		entries.clear();
+		// the last popped key
+		std::size_t floor = 0;
+		for (std::size_t step = 0; step < 2000; ++step) {
+			const auto id = rng() % 200;
+			const auto key = (monotone ? floor : 0) + rng() % 1000;
+			const auto action = rng() % 3;
+			if (action == 0 && !entries.empty()) {
+				assert(heap.topKey() == entries.begin()->first);
+				const auto top = std::make_pair(heap.topKey(), heap.top());
+				assert(entries.count(top) != 0);
+				entries.erase(entries.find(top));
+				heap.pop();
+				floor = top.first;
+			} else {
+				if (action == 1)
+					heap.decrease(id, key);
+				else
+					heap.push(id, key);
+				entries.emplace(key, id);
+			}
+			assert(heap.size() == entries.size());
+			assert(!heap.contains(id));
+		}
+	}
+}
+
+} // namespace
+
+int main()
+{
+	std::mt19937 rng{32};
+	checkIndexed<IndexedHeap<std::size_t>>(rng);
+	checkIndexed<IndexedHeap<std::size_t, 2>>(rng);
+	checkIndexed<IndexedHeap<std::size_t, 8>>(rng);
+	checkLazy<LazyHeap<std::size_t>>(rng, false);
+	checkLazy<RadixHeap<std::size_t>>(rng, true);
+
+	std::cout << "heap_test: OK" << std::endl;
+	return 0;
+}
@@ -0,0 +1,156 @@
+#include "Graph.hpp"
+#include "HubLabels.hpp"
+#include "testing.hpp"
+#include <cassert>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+void checkAll(const G& graph, const HubLabels& labels)
+{
+	assert(labels.nrOfVertices() == graph.nrOfVertices());
+	for (std::size_t s = 0; s < graph.nrOfVertices(); ++s)
+		for (std::size_t t = 0; t < graph.nrOfVertices(); ++t)
+			assert(labels.distance(s, t) == distance(graph, s, t));
+}
+
+// the data with a value written over the bytes at the position
+template <typename T>
+std::string patched(std::string data, std::size_t position, T value)
+{
+	std::memcpy(&data[position], &value, sizeof(value));
+	return data;
+}
+
+// load() and map() both reject the data
+void assertRejected(const std::string& data)
+{
+	std::stringstream stream{data};
+	bool thrown = false;
+	try {
+		HubLabels::load(stream);
+	} catch (const std::runtime_error&) {
+		thrown = true;
+	}
+	assert(thrown);
+
+	const char* path = "hublabels_test.tmp";
+	{
+		std::ofstream file{path, std::ios::binary};
+		file << data;
+	}
+	thrown = false;
+	try {
+		HubLabels::map(path);
+	} catch (const std::runtime_error&) {
+		thrown = true;
+	}
+	std::remove(path);
+	assert(thrown);
+}
+
+// positions follow the layout of the file: a 32 byte header (magic,
+// reserved, vertices, out and in entries), out and in offsets, out and in
+// distances, out and in hubs
+void checkCorrupted(const std::string& data, std::size_t vertices)
+{
+	std::uint64_t out_entries;
+	std::memcpy(&out_entries, &data[16], sizeof(out_entries));
+	const std::size_t out_offsets = 32;
+	const std::size_t in_offsets = out_offsets + 8 * (vertices + 1);
+	const std::size_t distances = in_offsets + 8 * (vertices + 1);
+	std::uint64_t in_entries;
+	std::memcpy(&in_entries, &data[24], sizeof(in_entries));
+	const std::size_t out_hubs = distances + 8 * (out_entries + in_entries);
+
+	assertRejected(patched(data, 0, 'X'));
+	assertRejected(data.substr(0, 16));
+	assertRejected(data.substr(0, data.size() - 8));
+	// counts not matching the size, or big enough to overflow it
+	assertRejected(patched(data, 8, std::uint64_t{vertices + 1}));
+	assertRejected(patched(data, 16, out_entries + 1));
+	assertRejected(patched(data, 24, std::uint64_t{1} << 62));
+	assertRejected(patched(data, 8, std::uint64_t{1} << 61));
+	// offsets going back or not ending at the number of entries
+	assertRejected(patched(data, out_offsets, std::uint64_t{1}));
+	assertRejected(patched(data, in_offsets + 8 * vertices, in_entries - 1));
+	if (vertices >= 2)
+		assertRejected(patched(data, out_offsets + 8, out_entries));
+	// hub out of range, the label of vertex 0 starts with its first hub
+	std::uint64_t first_end;
+	std::memcpy(&first_end, &data[out_offsets + 8], sizeof(first_end));
+	if (first_end > 1)
+		assertRejected(
+			patched(data, out_hubs, static_cast<std::uint32_t>(vertices)));
+	// missing sentinel
+	assertRejected(
+		patched(data, out_hubs + 4 * (first_end - 1), std::uint32_t{0}));
+}
+
+} // namespace
+
+int main()
+{
+	std::mt19937 rng{38};
+	for (std::size_t round = 0; round < 50; ++round) {
+		const auto vertices = 1 + rng() % 30;
+		const auto graph = randomGraph(rng, vertices, rng() % (4 * vertices));
+		const auto labels = HubLabels::build(graph, length);
+		checkAll(graph, labels);
+
+		// copies own their labels, the original can go away
+		HubLabels copy;
+		{
+			auto original = HubLabels::build(graph, length);
+			HubLabels constructed{original};
+			copy = original;
+			original = HubLabels{};
+			checkAll(graph, constructed);
+		}
+		checkAll(graph, copy);
+
+		std::stringstream stream;
+		labels.save(stream);
+		const auto data = stream.str();
+		checkAll(graph, HubLabels::load(stream));
+		checkCorrupted(data, vertices);
+	}
+
+	// a mapped file, shared by copies
+	const auto graph = randomGraph(rng, 40, 160);
+	const char* path = "hublabels_test.tmp";
+	{
+		std::ofstream file{path, std::ios::binary};
+		HubLabels::build(graph, length).save(file);
+	}
+	HubLabels copy;
+	{
+		const auto mapped = HubLabels::map(path);
+		copy = mapped;
+	}
+	std::remove(path);
+	checkAll(graph, copy);
+
+	// negative lengths are rejected
+	auto negative = randomGraph(rng, 3, 0);
+	negative.insertEdge(0, 1, 1.);
+	negative.insertEdge(1, 2, -1.);
+	bool thrown = false;
+	try {
+		HubLabels::build(negative, length);
+	} catch (const std::domain_error&) {
+		thrown = true;
+	}
+	assert(thrown);
+
+	std::cout << "hublabels_test: OK" << std::endl;
+	return 0;
+}
@@ -0,0 +1,72 @@
+#include "Graph.hpp"
+#include "Johnson.hpp"
+#include "ThreadPool.hpp"
+#include "testing.hpp"
+#include <cassert>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+int main()
+{
+	const auto infinity = std::numeric_limits<double>::infinity();
+	std::mt19937 rng{44};
+	SearchWorkspace<double> workspace{};
+	ThreadPool pool{3};
+	for (std::size_t round = 0; round < 50; ++round) {
+		const auto vertices = 1 + rng() % 30;
+		const auto original
+			= randomGraph(rng, vertices, rng() % (4 * vertices));
+		auto graph = original;
+		const auto potential = reweight(rng, graph);
+		const auto johnson = Johnson::build(graph, length, 2);
+		assert(johnson.nrOfVertices() == vertices);
+		for (std::size_t s = 0; s < vertices; ++s) {
+			std::vector<double> expected(vertices);
+			for (std::size_t t = 0; t < vertices; ++t)
+				expected[t]
+					= distance(original, s, t) + potential[t] - potential[s];
+			// Bellman-Ford with any number of threads or a caller's pool
+			assert(graph.bellmanFord(s, length, 1).distance == expected);
+			assert(graph.bellmanFord(s, length, 0).distance == expected);
+			assert(graph.bellmanFord(s, length, pool).distance == expected);
+			assert(johnson.distances(s) == expected);
+			for (std::size_t t = 0; t < vertices; ++t) {
+				try {
+					const auto [cost, path] = johnson.query(s, t, workspace);
+					assert(cost == expected[t]);
+					assert(path.front() == s && path.back() == t);
+					assert(pathLength(graph, path) == cost);
+				} catch (const std::runtime_error&) {
+					assert(expected[t] == infinity);
+				}
+			}
+		}
+	}
+
+	// a negative cycle, found by Bellman-Ford in any part of the graph
+	auto graph = randomGraph(rng, 30, 60);
+	graph.insertEdge(10, 11, 1.);
+	graph.insertEdge(11, 10, -2.);
+	bool thrown = false;
+	try {
+		Johnson::build(graph, length);
+	} catch (const std::domain_error&) {
+		thrown = true;
+	}
+	assert(thrown);
+
+	// Dijkstra rejects the negative lengths Bellman-Ford allows
+	thrown = false;
+	try {
+		graph.dijkstra(11, 10, length);
+	} catch (const std::domain_error&) {
+		thrown = true;
+	}
+	assert(thrown);
+
+	std::cout << "johnson_test: OK" << std::endl;
+	return 0;
+}
@@ -0,0 +1,82 @@
+#include "Graph.hpp"
+#include "ThreadPool.hpp"
+#include "testing.hpp"
+#include <cassert>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace {
+
+// BFSIterator from the seed, cut at depth k
+std::vector<std::size_t> reference(
+	const G& graph,
+	std::size_t seed,
+	std::size_t k)
+{
+	std::vector<std::size_t> out;
+	for (auto it = graph.beginBFS(seed);
+		 it != graph.endBFS() && it.depth() <= k;
+		 ++it)
+		out.push_back(static_cast<std::size_t>(*it));
+	return out;
+}
+
+void check(
+	const G& graph,
+	const std::vector<std::size_t>& seeds,
+	std::size_t k,
+	const G::Neighborhoods& result)
+{
+	assert(result.offsets.size() == seeds.size() + 1);
+	assert(result.offsets.front() == 0);
+	assert(result.offsets.back() == result.vertices.size());
+	for (std::size_t i = 0; i < seeds.size(); ++i) {
+		assert(result.offsets[i] <= result.offsets[i + 1]);
+		const std::vector<std::size_t> neighborhood(
+			result.vertices.begin() + result.offsets[i],
+			result.vertices.begin() + result.offsets[i + 1]);
+		assert(neighborhood == reference(graph, seeds[i], k));
+	}
+}
+
+} // namespace
+
+int main()
+{
+	std::mt19937 rng{30};
+	ThreadPool pool{4};
+	for (std::size_t round = 0; round < 100; ++round) {
+		const auto vertices = 1 + rng() % 60;
+		const auto graph = randomGraph(rng, vertices, rng() % (3 * vertices));
+		// more seeds than one block, with duplicates
+		std::vector<std::size_t> seeds(rng() % 300);
+		for (auto& seed : seeds)
+			seed = rng() % vertices;
+		const auto k = rng() % 6;
+
+		const auto single = graph.kHopNeighborhoods(seeds, k, 1);
+		check(graph, seeds, k, single);
+		// the result does not depend on the number of threads
+		for (std::size_t threads : {0, 3, 8}) {
+			const auto result = graph.kHopNeighborhoods(seeds, k, threads);
+			assert(result.offsets == single.offsets);
+			assert(result.vertices == single.vertices);
+		}
+		const auto pooled = graph.kHopNeighborhoods(seeds, k, pool);
+		assert(pooled.offsets == single.offsets);
+		assert(pooled.vertices == single.vertices);
+	}
+
+	// k = 0 gives the seeds only, no seeds give an empty result
+	const auto graph = randomGraph(rng, 10, 30);
+	const auto seeds_only = graph.kHopNeighborhoods({3, 3, 7}, 0, 2);
+	assert((seeds_only.offsets == std::vector<std::size_t>{0, 1, 2, 3}));
+	assert((seeds_only.vertices == std::vector<std::size_t>{3, 3, 7}));
+	const auto empty = graph.kHopNeighborhoods({}, 5, 2);
+	assert((empty.offsets == std::vector<std::size_t>{0}));
+	assert(empty.vertices.empty());
+
+	std::cout << "khopneighborhoods_test: OK" << std::endl;
+	return 0;
+}
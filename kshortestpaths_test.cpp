@@ -0,0 +1,79 @@
+#include "Graph.hpp"
+#include "testing.hpp"
+#include <algorithm>
+#include <cassert>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace {
+
+// lengths of all loopless paths from the vertex at the back of the path to
+// the end, found by depth-first enumeration
+void enumerate(
+	const G& graph,
+	std::size_t end,
+	std::vector<std::size_t>& path,
+	std::vector<char>& on_path,
+	double cost,
+	std::vector<double>& out)
+{
+	const auto current = path.back();
+	if (current == end) {
+		out.push_back(cost);
+		return;
+	}
+	for (std::size_t i = 0; i < graph.nrOfVertices(); ++i) {
+		if (on_path[i] || !graph.edgeExist(current, i))
+			continue;
+		on_path[i] = 1;
+		path.push_back(i);
+		enumerate(
+			graph, end, path, on_path, cost + graph.edgeLabel(current, i), out);
+		path.pop_back();
+		on_path[i] = 0;
+	}
+}
+
+} // namespace
+
+int main()
+{
+	std::mt19937 rng{49};
+	for (std::size_t round = 0; round < 300; ++round) {
+		const auto vertices = 1 + rng() % 8;
+		const auto graph = randomGraph(rng, vertices, rng() % (4 * vertices));
+		const auto start = rng() % vertices;
+		const auto end = rng() % vertices;
+		const auto k = 1 + rng() % 20;
+
+		std::vector<double> expected;
+		std::vector<std::size_t> path{start};
+		std::vector<char> on_path(vertices, 0);
+		on_path[start] = 1;
+		enumerate(graph, end, path, on_path, 0, expected);
+		std::sort(expected.begin(), expected.end());
+		expected.resize(std::min(expected.size(), k));
+
+		// equal lengths may come in any order, so only lengths are compared,
+		// paths have to be loopless, distinct and of the reported length
+		const auto result = graph.kShortestPaths(start, end, k, length);
+		assert(result.size() == expected.size());
+		for (std::size_t i = 0; i < result.size(); ++i) {
+			const auto& [cost, found] = result[i];
+			assert(cost == expected[i]);
+			assert(found.front() == start && found.back() == end);
+			std::vector<char> seen(vertices, 0);
+			for (const auto vertex : found) {
+				assert(!seen[vertex]);
+				seen[vertex] = 1;
+			}
+			assert(pathLength(graph, found) == cost);
+			for (std::size_t j = 0; j < i; ++j)
+				assert(result[j].second != found);
+		}
+	}
+
+	std::cout << "kshortestpaths_test: OK" << std::endl;
+	return 0;
+}
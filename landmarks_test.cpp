@@ -0,0 +1,75 @@
+#include "Graph.hpp"
+#include "Landmarks.hpp"
+#include "testing.hpp"
+#include <cassert>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <stdexcept>
+
+using Selection = Landmarks::Selection;
+
+namespace {
+
+// bounds are admissible and consistent, A* with them finds the lengths of
+// Graph::dijkstra
+void check(const G& graph, const Landmarks& landmarks)
+{
+	const auto infinity = std::numeric_limits<double>::infinity();
+	const auto vertices = graph.nrOfVertices();
+	assert(landmarks.nrOfVertices() == vertices);
+	const auto heuristic = landmarks.heuristic();
+	for (std::size_t t = 0; t < vertices; ++t) {
+		for (std::size_t s = 0; s < vertices; ++s) {
+			const auto expected = distance(graph, s, t);
+			const auto bound = landmarks.lowerBound(s, t);
+			assert(bound <= expected);
+			for (std::size_t v = 0; v < vertices; ++v)
+				if (graph.edgeExist(s, v))
+					assert(
+						bound
+						<= graph.edgeLabel(s, v) + landmarks.lowerBound(v, t));
+			if (expected == infinity)
+				continue;
+			const auto result = graph.a_star(s, t, length, heuristic);
+			assert(result.first == expected);
+		}
+	}
+}
+
+} // namespace
+
+int main()
+{
+	std::mt19937 rng{37};
+	for (std::size_t round = 0; round < 40; ++round) {
+		const auto vertices = 1 + rng() % 30;
+		const auto graph = randomGraph(rng, vertices, rng() % (4 * vertices));
+		const auto count = 1 + rng() % 4;
+		for (const auto selection : {Selection::FARTHEST, Selection::AVOID})
+			check(graph, Landmarks::build(graph, length, count, selection));
+
+		// no landmarks give the trivial bound
+		const auto none = Landmarks::build(graph, length, 0);
+		assert(none.landmarks().empty());
+		for (std::size_t s = 0; s < vertices; ++s)
+			for (std::size_t t = 0; t < vertices; ++t)
+				assert(none.lowerBound(s, t) == 0);
+		check(graph, none);
+	}
+
+	// negative lengths are rejected
+	auto graph = randomGraph(rng, 3, 0);
+	graph.insertEdge(0, 1, 1.);
+	graph.insertEdge(1, 2, -1.);
+	bool thrown = false;
+	try {
+		Landmarks::build(graph, length, 2);
+	} catch (const std::domain_error&) {
+		thrown = true;
+	}
+	assert(thrown);
+
+	std::cout << "landmarks_test: OK" << std::endl;
+	return 0;
+}
@@ -0,0 +1,87 @@
+#include "Graph.hpp"
+#include "PathCache.hpp"
+#include "testing.hpp"
+#include <cassert>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <utility>
+
+int main()
+{
+	const auto zero = [](const G&, std::size_t, std::size_t) { return 0.; };
+	std::mt19937 rng{45};
+
+	const std::size_t vertices = 60;
+	auto graph = randomGraph(rng, vertices, 200);
+
+	const std::size_t limit = 40000;
+	PathCache<int, double> cache{graph, limit};
+	for (std::size_t round = 0; round < 20000; ++round) {
+		// lengths change through setEdgeLabel, which invalidates the cache
+		if (round % 1000 == 999) {
+			const auto from = rng() % vertices;
+			const auto to = rng() % vertices;
+			if (graph.edgeExist(from, to))
+				graph.setEdgeLabel(from, to, static_cast<double>(rng() % 10));
+			else
+				graph.insertEdge(from, to, static_cast<double>(rng() % 10));
+		}
+		// a few starts, so that queries repeat
+		const auto start = rng() % 8;
+		const auto end = rng() % vertices;
+		const auto expected = distance(graph, start, end);
+		try {
+			const auto [cost, path] = round % 3 != 0
+				? cache.dijkstra(start, end, length, 1)
+				: cache.a_star(start, end, length, zero, 2);
+			assert(cost == expected);
+			assert(path.front() == start && path.back() == end);
+			assert(pathLength(graph, path) == cost);
+		} catch (const std::runtime_error&) {
+			assert(expected == std::numeric_limits<double>::infinity());
+		}
+		assert(cache.bytes() <= limit);
+	}
+	assert(cache.hits() > 0);
+	assert(cache.hits() + cache.misses() == 20000);
+
+	// every modification changes the version, reading does not
+	auto version = graph.version();
+	const auto changed = [&] {
+		const auto current = graph.version();
+		const auto out = current != version;
+		version = current;
+		return out;
+	};
+	graph.insertVertex(static_cast<int>(vertices));
+	assert(changed());
+	graph.insertEdge(vertices, 0, 1.);
+	assert(changed());
+	graph.setEdgeLabel(vertices, 0, 2.);
+	assert(changed());
+	assert(graph.edgeLabel(vertices, 0) == 2.);
+	assert(std::as_const(graph).edgeLabel(vertices, 0) == 2.);
+	graph.dijkstra(vertices, 0, length);
+	assert(!changed());
+	graph.removeEdge(vertices, 0);
+	assert(changed());
+	graph.removeVertex(vertices);
+	assert(changed());
+
+	// setEdgeLabel does not create edges
+	graph.removeEdge(0, 0);
+	version = graph.version();
+	bool thrown = false;
+	try {
+		graph.setEdgeLabel(0, 0, 1.);
+	} catch (const std::logic_error&) {
+		thrown = true;
+	}
+	assert(thrown);
+	assert(!graph.edgeExist(0, 0) && !changed());
+
+	std::cout << "pathcache_test: OK" << std::endl;
+	return 0;
+}
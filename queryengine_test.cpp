@@ -0,0 +1,96 @@
+#include "Graph.hpp"
+#include "QueryEngine.hpp"
+#include "testing.hpp"
+#include <cassert>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+using Engine = QueryEngine<int, double>;
+
+// every result against a sequential Graph::dijkstra, missing paths are
+// infinite and empty
+void check(
+	const G& graph,
+	const std::vector<Engine::Query>& queries,
+	const std::vector<Engine::Result>& results)
+{
+	assert(results.size() == queries.size());
+	for (std::size_t i = 0; i < queries.size(); ++i) {
+		const auto [start, end] = queries[i];
+		const auto expected = distance(graph, start, end);
+		assert(results[i].first == expected);
+		if (expected == std::numeric_limits<double>::infinity()) {
+			assert(results[i].second.empty());
+			continue;
+		}
+		assert(results[i].second.front() == start);
+		assert(results[i].second.back() == end);
+		assert(pathLength(graph, results[i].second) == expected);
+	}
+}
+
+template <typename Exception, typename Batch>
+void assertThrows(Batch batch)
+{
+	bool thrown = false;
+	try {
+		batch();
+	} catch (const Exception&) {
+		thrown = true;
+	}
+	assert(thrown);
+}
+
+} // namespace
+
+int main()
+{
+	const auto int_length = [](const double& e) { return static_cast<int>(e); };
+	const auto zero = [](const G&, std::size_t, std::size_t) { return 0.; };
+	std::mt19937 rng{41};
+	for (std::size_t threads : {1, 3, 0}) {
+		for (std::size_t round = 0; round < 50; ++round) {
+			const auto vertices = 1 + rng() % 40;
+			const auto graph
+				= randomGraph(rng, vertices, rng() % (3 * vertices));
+			// one engine for several batches, so the workspaces are reused
+			Engine engine{graph, threads};
+			assert(engine.nrOfWorkers() == ThreadPool::threadCount(threads));
+			for (std::size_t batch = 0; batch < 3; ++batch) {
+				std::vector<Engine::Query> queries(rng() % 200);
+				for (auto& [start, end] : queries) {
+					start = rng() % vertices;
+					end = rng() % vertices;
+				}
+				// floating point and integral (radix heap) workspaces
+				check(graph, queries, engine.dijkstra(queries, length));
+				check(graph, queries, engine.dijkstra(queries, int_length));
+				check(graph, queries, engine.a_star(queries, length, zero));
+			}
+		}
+	}
+
+	// only a missing path is a result, other errors reach the caller
+	auto graph = randomGraph(rng, 3, 0);
+	graph.insertEdge(0, 1, 1.);
+	graph.insertEdge(1, 2, -1.);
+	Engine engine{graph, 2};
+	const std::vector<Engine::Query> queries{{0, 2}, {2, 0}};
+	assertThrows<std::domain_error>(
+		[&] { engine.dijkstra(queries, int_length); });
+	assertThrows<std::runtime_error>([&] {
+		engine.dijkstra(queries, [](const double& e) -> double {
+			if (e < 0)
+				throw std::runtime_error{"length"};
+			return e;
+		});
+	});
+
+	std::cout << "queryengine_test: OK" << std::endl;
+	return 0;
+}
@@ -0,0 +1,87 @@
+#include "Graph.hpp"
+#include "SearchWorkspace.hpp"
+#include "dijkstra.hpp"
+#include "testing.hpp"
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <type_traits>
+
+namespace {
+
+struct IntLength {
+	int value{0};
+	// returned by reference, the length type is still int
+	const int& operator()(const double& e)
+	{
+		value = static_cast<int>(e);
+		return value;
+	}
+};
+
+const auto unsigned_length
+	= [](const double& e) { return static_cast<unsigned>(e); };
+
+using Radix = SearchWorkspace<std::uint64_t, RadixHeap<std::uint64_t>>;
+
+static_assert(std::is_same_v<EdgeLength<IntLength, double>, int>);
+static_assert(std::is_same_v<SearchWorkspaceFor<int>, Radix>);
+static_assert(
+	std::is_same_v<SearchWorkspaceFor<EdgeLength<IntLength, double>>, Radix>);
+static_assert(std::is_same_v<SearchWorkspaceFor<unsigned>, Radix>);
+static_assert(
+	std::is_same_v<SearchWorkspaceFor<double>, SearchWorkspace<double>>);
+
+} // namespace
+
+int main()
+{
+	std::mt19937 rng{33};
+	Radix workspace;
+	for (std::size_t round = 0; round < 200; ++round) {
+		const auto vertices = 1 + rng() % 40;
+		auto graph = randomGraph(rng, vertices, rng() % (3 * vertices), 100);
+		const auto start = rng() % vertices;
+		for (std::size_t end = 0; end < vertices; ++end) {
+			const auto expected = distance(graph, start, end);
+			if (expected == std::numeric_limits<double>::infinity()) {
+				bool thrown = false;
+				try {
+					graph.dijkstra(start, end, IntLength{});
+				} catch (const std::runtime_error&) {
+					thrown = true;
+				}
+				assert(thrown);
+				continue;
+			}
+			// integral lengths take the radix heap, the results match the
+			// floating point search
+			const auto [cost, path] = graph.dijkstra(start, end, IntLength{});
+			assert(cost == expected);
+			assert(pathLength(graph, path) == cost);
+			assert(
+				graph.dijkstra(start, end, unsigned_length).first == expected);
+			assert(
+				graph.dijkstra(start, end, unsigned_length, workspace).first
+				== expected);
+			assert(dijkstra(graph, start, end, IntLength{}).first == expected);
+		}
+	}
+
+	// negative integral lengths are rejected
+	auto graph = randomGraph(rng, 3, 0);
+	graph.insertEdge(0, 1, 2.);
+	graph.insertEdge(1, 2, -1.);
+	bool thrown = false;
+	try {
+		graph.dijkstra(0, 2, IntLength{});
+	} catch (const std::domain_error&) {
+		thrown = true;
+	}
+	assert(thrown);
+
+	std::cout << "radixdijkstra_test: OK" << std::endl;
+	return 0;
+}
@@ -0,0 +1,78 @@
+#include "Graph.hpp"
+#include "testing.hpp"
+#include <cassert>
+#include <iostream>
+#include <limits>
+#include <random>
+
+namespace {
+
+// reachable() of the graph against BFS from every vertex
+void check(const G& graph)
+{
+	const auto none = std::numeric_limits<std::size_t>::max();
+	for (std::size_t u = 0; u < graph.nrOfVertices(); ++u) {
+		const auto expected = hops(graph, u);
+		for (std::size_t v = 0; v < graph.nrOfVertices(); ++v)
+			assert(graph.reachable(u, v) == (expected[v] != none));
+	}
+}
+
+} // namespace
+
+int main()
+{
+	std::mt19937 rng{29};
+	for (std::size_t round = 0; round < 200; ++round) {
+		const auto vertices = 1 + rng() % 150;
+		auto graph = randomGraph(rng, vertices, rng() % (2 * vertices));
+
+		// without an index reachable() runs a BFS
+		assert(!graph.hasReachabilityIndex());
+		check(graph);
+		// bit matrix
+		graph.buildReachabilityIndex();
+		assert(graph.hasReachabilityIndex());
+		check(graph);
+		// interval labelling, forced by a limit below the number of vertices
+		graph.buildReachabilityIndex(0);
+		assert(graph.hasReachabilityIndex());
+		check(graph);
+
+		// new edges update the matrix in place, it has to match a rebuilt one
+		graph.buildReachabilityIndex();
+		for (std::size_t i = 0; i < 20; ++i) {
+			graph.insertEdge(rng() % vertices, rng() % vertices, 1.);
+			assert(graph.hasReachabilityIndex());
+			auto rebuilt = graph;
+			rebuilt.buildReachabilityIndex();
+			for (std::size_t u = 0; u < vertices; ++u)
+				for (std::size_t v = 0; v < vertices; ++v)
+					assert(graph.reachable(u, v) == rebuilt.reachable(u, v));
+		}
+		check(graph);
+
+		// the interval labelling is dropped by a new edge, the bit matrix by
+		// a removed one
+		const auto from = rng() % vertices;
+		const auto to = rng() % vertices;
+		graph.removeEdge(from, to);
+		graph.buildReachabilityIndex(0);
+		graph.insertEdge(from, to, 1.);
+		assert(!graph.hasReachabilityIndex());
+		check(graph);
+		graph.buildReachabilityIndex();
+		graph.removeEdge(from, to);
+		assert(!graph.hasReachabilityIndex());
+		check(graph);
+
+		// and both by a new vertex
+		graph.buildReachabilityIndex();
+		graph.insertVertex(static_cast<int>(vertices));
+		assert(!graph.hasReachabilityIndex());
+		check(graph);
+	}
+
+	std::cout << "reachabilityindex_test: OK" << std::endl;
+	return 0;
+}
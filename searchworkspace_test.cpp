@@ -0,0 +1,84 @@
+#include "Graph.hpp"
+#include "SearchWorkspace.hpp"
+#include "testing.hpp"
+#include <cassert>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <vector>
+
+namespace {
+
+// distances from the start by repeated relaxation of every edge
+std::vector<double> reference(const G& graph, std::size_t start)
+{
+	const auto vertices = graph.nrOfVertices();
+	std::vector<double> out(
+		vertices, std::numeric_limits<double>::infinity());
+	out[start] = 0;
+	for (std::size_t pass = 0; pass < vertices; ++pass)
+		for (std::size_t u = 0; u < vertices; ++u)
+			for (std::size_t v = 0; v < vertices; ++v)
+				if (graph.edgeExist(u, v))
+					out[v] = std::min(out[v], out[u] + graph.edgeLabel(u, v));
+	return out;
+}
+
+} // namespace
+
+int main()
+{
+	const auto zero = [](const G&, std::size_t, std::size_t) { return 0.; };
+	std::mt19937 rng{31};
+	// one workspace for graphs growing and shrinking between searches, so
+	// stale state of bigger graphs is left in it
+	SearchWorkspace<double> workspace;
+	for (std::size_t round = 0; round < 300; ++round) {
+		const auto vertices = 1 + rng() % 40;
+		const auto graph = randomGraph(rng, vertices, rng() % (3 * vertices));
+		const auto start = rng() % vertices;
+		const auto expected = reference(graph, start);
+		for (std::size_t end = 0; end < vertices; ++end) {
+			if (expected[end] == std::numeric_limits<double>::infinity()) {
+				bool thrown = false;
+				try {
+					graph.dijkstra(start, end, length, workspace);
+				} catch (const std::runtime_error&) {
+					thrown = true;
+				}
+				assert(thrown);
+				continue;
+			}
+			const auto [cost, path]
+				= graph.dijkstra(start, end, length, workspace);
+			assert(cost == expected[end]);
+			assert(path.front() == start && path.back() == end);
+			assert(pathLength(graph, path) == cost);
+			const auto [a_cost, a_path]
+				= graph.a_star(start, end, length, zero, workspace);
+			assert(a_cost == expected[end]);
+			assert(pathLength(graph, a_path) == a_cost);
+			// a fresh workspace gives the same result
+			assert(graph.dijkstra(start, end, length).second == path);
+		}
+	}
+
+	// reset() forgets everything, reached and settled vertices stay per
+	// search
+	workspace.reset(5);
+	for (std::size_t i = 0; i < 5; ++i)
+		assert(!workspace.reached(i) && !workspace.settled(i));
+	workspace.reach(2, 7., 2);
+	workspace.reach(3, 9., 2);
+	workspace.settle(2);
+	assert(workspace.reached(2) && workspace.settled(2));
+	assert(workspace.reached(3) && !workspace.settled(3));
+	assert(workspace.distance(3) == 9. && workspace.previous(3) == 2);
+	assert((workspace.path(3) == std::vector<std::size_t>{2, 3}));
+	workspace.reset(3);
+	for (std::size_t i = 0; i < 3; ++i)
+		assert(!workspace.reached(i) && !workspace.settled(i));
+
+	std::cout << "searchworkspace_test: OK" << std::endl;
+	return 0;
+}
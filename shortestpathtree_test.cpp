@@ -0,0 +1,93 @@
+#include "Graph.hpp"
+#include "testing.hpp"
+#include <algorithm>
+#include <cassert>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <vector>
+
+namespace {
+
+// vertices in the tree have their exact distance and a parent edge matching
+// it, the others have none
+void checkTree(
+	const G& graph,
+	std::size_t source,
+	const G::ShortestPathTree& tree,
+	const std::vector<double>& expected)
+{
+	const auto vertices = graph.nrOfVertices();
+	assert(tree.distance.size() == vertices);
+	assert(tree.parent.size() == vertices);
+	assert(tree.parent[source] == source && tree.distance[source] == 0);
+	for (std::size_t v = 0; v < vertices; ++v) {
+		if (tree.parent[v] == vertices) {
+			assert(tree.distance[v] == std::numeric_limits<double>::infinity());
+			continue;
+		}
+		assert(tree.distance[v] == expected[v]);
+		if (v == source)
+			continue;
+		const auto parent = tree.parent[v];
+		assert(tree.parent[parent] != vertices);
+		assert(graph.edgeExist(parent, v));
+		assert(
+			tree.distance[parent] + graph.edgeLabel(parent, v) == expected[v]);
+	}
+}
+
+} // namespace
+
+int main()
+{
+	const auto infinity = std::numeric_limits<double>::infinity();
+	const auto int_length = [](const double& e) { return static_cast<int>(e); };
+	std::mt19937 rng{39};
+	for (std::size_t round = 0; round < 300; ++round) {
+		const auto vertices = 1 + rng() % 40;
+		const auto graph = randomGraph(rng, vertices, rng() % (3 * vertices));
+		const auto source = rng() % vertices;
+		std::vector<double> expected(vertices);
+		for (std::size_t v = 0; v < vertices; ++v)
+			expected[v] = distance(graph, source, v);
+
+		// the whole tree
+		const auto full = graph.shortestPathTree(source, length);
+		checkTree(graph, source, full, expected);
+		assert(full.distance == expected);
+		assert(graph.shortestPathTree(source, int_length).distance == expected);
+
+		// exactly the vertices within the radius
+		const auto radius = static_cast<double>(rng() % 30);
+		const auto near = graph.shortestPathTree(source, length, radius);
+		checkTree(graph, source, near, expected);
+		for (std::size_t v = 0; v < vertices; ++v)
+			assert((near.distance[v] != infinity) == (expected[v] <= radius));
+
+		// every reachable target, nothing farther than the farthest one
+		std::vector<std::size_t> targets(rng() % 5);
+		for (auto& target : targets)
+			target = rng() % vertices;
+		const auto partial = graph.shortestPathTree(source, length, targets);
+		checkTree(graph, source, partial, expected);
+		double farthest = 0;
+		for (const auto target : targets) {
+			assert(partial.distance[target] == expected[target]);
+			if (expected[target] != infinity)
+				farthest = std::max(farthest, expected[target]);
+		}
+		const auto unreachable = std::any_of(
+			targets.begin(), targets.end(), [&](std::size_t target) {
+				return expected[target] == infinity;
+			});
+		if (!unreachable)
+			for (std::size_t v = 0; v < vertices; ++v)
+				assert(
+					partial.distance[v] == infinity
+					|| partial.distance[v] <= farthest);
+	}
+
+	std::cout << "shortestpathtree_test: OK" << std::endl;
+	return 0;
+}
@@ -0,0 +1,95 @@
+#ifndef TESTING_HPP
+#define TESTING_HPP
+
+#include <cassert>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include "Graph.hpp"
+
+// helpers shared by the *_test.cpp programs
+
+using G = Graph<int, double>;
+
+// labels are the lengths
+inline const auto length = [](const double& e) { return e; };
+
+// vertex i holds i, lengths are integers in [0, max_length), so sums of them
+// are exact and results of different algorithms can be compared with ==
+inline G randomGraph(
+	std::mt19937& rng,
+	std::size_t vertices,
+	std::size_t edges,
+	std::size_t max_length = 10)
+{
+	G graph;
+	for (std::size_t i = 0; i < vertices; ++i)
+		graph.insertVertex(static_cast<int>(i));
+	for (std::size_t i = 0; i < edges; ++i) {
+		const auto from = rng() % vertices;
+		const auto to = rng() % vertices;
+		graph.insertEdge(from, to, static_cast<double>(rng() % max_length));
+	}
+	return graph;
+}
+
+// sum of the lengths along the path, every edge of it has to exist
+inline double pathLength(const G& graph, const std::vector<std::size_t>& path)
+{
+	double out = 0;
+	for (std::size_t i = 1; i < path.size(); ++i) {
+		assert(graph.edgeExist(path[i - 1], path[i]));
+		out += graph.edgeLabel(path[i - 1], path[i]);
+	}
+	return out;
+}
+
+// length of a shortest path by Graph::dijkstra, infinity if there is none
+inline double distance(const G& graph, std::size_t start, std::size_t end)
+{
+	try {
+		return graph.dijkstra(start, end, length).first;
+	} catch (const std::runtime_error&) {
+		return std::numeric_limits<double>::infinity();
+	}
+}
+
+// lengths w + p(to) - p(from) of a graph with w >= 0 with random vertex
+// potentials p, they are negative for some edges, but no cycle is negative
+// and the distances become d(s, t) + p(t) - p(s), returns the potentials
+inline std::vector<double> reweight(std::mt19937& rng, G& graph)
+{
+	const auto vertices = graph.nrOfVertices();
+	std::vector<double> potential(vertices);
+	for (auto& p : potential)
+		p = static_cast<double>(rng() % 10);
+	for (std::size_t u = 0; u < vertices; ++u)
+		for (std::size_t v = 0; v < vertices; ++v)
+			if (graph.edgeExist(u, v))
+				graph.insertEdge(
+					u, v, graph.edgeLabel(u, v) + potential[v] - potential[u]);
+	return potential;
+}
+
+// vertices reachable from the start by BFS, with their number of edges from
+// it (max() - unreachable)
+inline std::vector<std::size_t> hops(const G& graph, std::size_t start)
+{
+	const auto vertices = graph.nrOfVertices();
+	std::vector<std::size_t> out(
+		vertices, std::numeric_limits<std::size_t>::max());
+	std::vector<std::size_t> queue{start};
+	out[start] = 0;
+	for (std::size_t head = 0; head < queue.size(); ++head)
+		for (std::size_t i = 0; i < vertices; ++i)
+			if (graph.edgeExist(queue[head], i)
+				&& out[i] == std::numeric_limits<std::size_t>::max()) {
+				out[i] = out[queue[head]] + 1;
+				queue.push_back(i);
+			}
+	return out;
+}
+
+#endif /* TESTING_HPP */
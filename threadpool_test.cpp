@@ -0,0 +1,49 @@
+#include "ThreadPool.hpp"
+#include <atomic>
+#include <cassert>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+
+int main()
+{
+	for (std::size_t threads : {0, 1, 2, 5}) {
+		ThreadPool pool{threads};
+		assert(pool.size() == ThreadPool::threadCount(threads));
+		assert(pool.size() >= 1);
+
+		// every index exactly once, worker ids in [0, size())
+		for (std::size_t count : {0, 1, 7, 64, 1000, 12345}) {
+			std::vector<std::atomic<std::size_t>> visits(count);
+			std::atomic<bool> valid_worker{true};
+			pool.parallelFor(count, [&](std::size_t worker, std::size_t i) {
+				if (worker >= pool.size())
+					valid_worker = false;
+				++visits[i];
+			});
+			assert(valid_worker);
+			for (const auto& visit : visits)
+				assert(visit == 1);
+		}
+
+		// the exception is rethrown and the pool stays usable
+		bool thrown = false;
+		try {
+			pool.parallelFor(1000, [](std::size_t, std::size_t i) {
+				if (i == 500)
+					throw std::runtime_error{"test"};
+			});
+		} catch (const std::runtime_error&) {
+			thrown = true;
+		}
+		assert(thrown);
+		std::atomic<std::size_t> sum{0};
+		pool.parallelFor(100, [&](std::size_t, std::size_t i) { sum += i; });
+		assert(sum == 4950);
+	}
+	assert(ThreadPool::threadCount(3) == 3);
+	assert(ThreadPool::threadCount(0) >= 1);
+
+	std::cout << "threadpool_test: OK" << std::endl;
+	return 0;
+}
@@ -0,0 +1,97 @@
+#include "Graph.hpp"
+#include "testing.hpp"
+#include <cassert>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+// order() is a permutation, position() its inverse, every edge goes forward
+void checkOrder(const G& graph)
+{
+	const auto vertices = graph.nrOfVertices();
+	const auto& topological = graph.topologicalOrder();
+	const auto& order = topological.order();
+	assert(order.size() == vertices);
+	for (std::size_t i = 0; i < vertices; ++i) {
+		assert(order[i] < vertices);
+		assert(topological.position(order[i]) == i);
+	}
+	for (std::size_t u = 0; u < vertices; ++u)
+		for (std::size_t v = 0; v < vertices; ++v)
+			if (graph.edgeExist(u, v))
+				assert(topological.position(u) < topological.position(v));
+}
+
+std::size_t nrOfEdges(const G& graph)
+{
+	std::size_t out = 0;
+	for (std::size_t u = 0; u < graph.nrOfVertices(); ++u)
+		for (std::size_t v = 0; v < graph.nrOfVertices(); ++v)
+			out += graph.edgeExist(u, v);
+	return out;
+}
+
+} // namespace
+
+int main()
+{
+	const auto none = std::numeric_limits<std::size_t>::max();
+	std::mt19937 rng{28};
+	for (std::size_t round = 0; round < 100; ++round) {
+		auto graph = randomGraph(rng, 1 + rng() % 20, 0);
+		assert(graph.enableDagMode());
+		for (std::size_t step = 0; step < 200; ++step) {
+			const auto vertices = graph.nrOfVertices();
+			const auto action = rng() % 20;
+			if (action == 0 && vertices > 1) {
+				graph.removeVertex(rng() % vertices);
+			} else if (action == 1) {
+				graph.insertVertex(static_cast<int>(vertices));
+			} else if (action == 2) {
+				graph.removeEdge(rng() % vertices, rng() % vertices);
+			} else {
+				const auto from = rng() % vertices;
+				const auto to = rng() % vertices;
+				// a new edge closes a cycle if its end reaches its start
+				const auto cycle = !graph.edgeExist(from, to)
+					&& hops(graph, to)[from] != none;
+				const auto order = graph.topologicalOrder().order();
+				const auto edges = nrOfEdges(graph);
+				const auto inserted = graph.insertEdge(from, to, 1.).second;
+				assert(inserted == !cycle);
+				if (cycle) {
+					// rejected without any change
+					assert(!graph.edgeExist(from, to));
+					assert(nrOfEdges(graph) == edges);
+					assert(graph.topologicalOrder().order() == order);
+				}
+			}
+			checkOrder(graph);
+		}
+
+		graph.disableDagMode();
+		bool thrown = false;
+		try {
+			graph.topologicalOrder();
+		} catch (const std::logic_error&) {
+			thrown = true;
+		}
+		assert(thrown);
+	}
+
+	// DAG mode cannot be entered while there is a cycle
+	auto graph = randomGraph(rng, 3, 0);
+	graph.insertEdge(0, 1, 1.);
+	graph.insertEdge(1, 2, 1.);
+	graph.insertEdge(2, 0, 1.);
+	assert(!graph.enableDagMode() && !graph.dagMode());
+	graph.removeEdge(2, 0);
+	assert(graph.enableDagMode() && graph.dagMode());
+	checkOrder(graph);
+
+	std::cout << "topologicalorder_test: OK" << std::endl;
+	return 0;
+}
@@ -0,0 +1,107 @@
+#include "Graph.hpp"
+#include "WeightProfile.hpp"
+#include "testing.hpp"
+#include <cassert>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+template <typename Exception, typename Search>
+void assertThrows(Search search)
+{
+	bool thrown = false;
+	try {
+		search();
+	} catch (const Exception&) {
+		thrown = true;
+	}
+	assert(thrown);
+}
+
+} // namespace
+
+int main()
+{
+	const auto infinity = std::numeric_limits<double>::infinity();
+	std::mt19937 rng{47};
+	SearchWorkspace<double> workspace;
+	for (std::size_t round = 0; round < 100; ++round) {
+		const auto vertices = 1 + rng() % 40;
+		auto graph = randomGraph(rng, vertices, rng() % (3 * vertices));
+		// points on a line, every edge is at least as long as the distance
+		// of its ends, so the distance on the line is a consistent heuristic
+		std::vector<int> position(vertices);
+		for (auto& p : position)
+			p = static_cast<int>(rng() % 30);
+		std::size_t edges = 0;
+		for (std::size_t u = 0; u < vertices; ++u)
+			for (std::size_t v = 0; v < vertices; ++v)
+				if (graph.edgeExist(u, v)) {
+					++edges;
+					graph.setEdgeLabel(
+						u,
+						v,
+						std::abs(position[u] - position[v])
+							+ graph.edgeLabel(u, v));
+				}
+		std::size_t calls = 0;
+		const auto h = [&](const G&, std::size_t u, std::size_t v) {
+			++calls;
+			return static_cast<double>(std::abs(position[u] - position[v]));
+		};
+
+		auto profile = WeightProfile::build(graph, length);
+		assert(profile.nrOfVertices() == vertices);
+		assert(profile.nrOfEdges() == edges);
+		assert(profile.version() == graph.version());
+		assert(!profile.hasHeuristic());
+		assert(profile.heuristicTarget() == vertices);
+		assertThrows<std::logic_error>([&] { profile.a_star(0, 0); });
+
+		const auto start = rng() % vertices;
+		for (std::size_t end = 0; end < vertices; ++end) {
+			const auto expected = distance(graph, start, end);
+			// the heuristic is called once per vertex when cached, never
+			// by the searches
+			calls = 0;
+			profile.cacheHeuristic(graph, h, end);
+			assert(calls == vertices);
+			assert(profile.hasHeuristic() && profile.heuristicTarget() == end);
+			if (expected == infinity) {
+				assertThrows<std::runtime_error>(
+					[&] { profile.dijkstra(start, end); });
+				assertThrows<std::runtime_error>(
+					[&] { profile.a_star(start, end); });
+				continue;
+			}
+			const auto [cost, path] = profile.dijkstra(start, end);
+			assert(cost == expected);
+			assert(path.front() == start && path.back() == end);
+			assert(pathLength(graph, path) == cost);
+			assert(profile.dijkstra(start, end, workspace).first == expected);
+			const auto [a_cost, a_path] = profile.a_star(start, end);
+			assert(a_cost == expected);
+			assert(pathLength(graph, a_path) == a_cost);
+			assert(profile.a_star(start, end, workspace).first == expected);
+			assert(calls == vertices);
+			// the cached heuristic belongs to one target
+			if (vertices > 1)
+				assertThrows<std::logic_error>(
+					[&] { profile.a_star(start, (end + 1) % vertices); });
+		}
+	}
+
+	auto graph = randomGraph(rng, 3, 0);
+	graph.insertEdge(0, 1, 1.);
+	graph.insertEdge(1, 2, -1.);
+	assertThrows<std::domain_error>(
+		[&] { WeightProfile::build(graph, length); });
+
+	std::cout << "weightprofile_test: OK" << std::endl;
+	return 0;
+}